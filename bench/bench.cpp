@@ -0,0 +1,659 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+/*
+ * nccpp_bench : throughput and latency benchmarks for ncursescpp.
+ *
+ * The library is bound to a virtual terminal, so the number of bytes sent to
+ * the terminal for each frame can be measured exactly without a tty. Results
+ * are written to the standard output, one JSON object per line.
+ *
+ * Usage : nccpp_bench [--filter substring] [--min-time-ms ms] [--term name]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <clocale>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "src/ncursescpp.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+struct Size
+{
+	int lines;
+	int cols;
+};
+
+struct Options
+{
+	std::string filter;
+	double min_time_ms;
+	std::string term;
+};
+
+class Runner
+{
+	public:
+	Runner(Options const& opts, nccpp::VirtualTerminal& term)
+		: opts_(opts), term_(term)
+	{}
+
+	/*
+	 * Time op(i) for a growing number of iterations until the run lasts at least
+	 * min_time_ms, then report the last run. If frames is true, op is expected to
+	 * update the terminal and the bytes it emitted are reported per iteration.
+	 */
+	template <typename Op>
+	void run(char const* name, Size size, bool frames, Op&& op)
+	{
+		if (!opts_.filter.empty() && std::string{name}.find(opts_.filter) == std::string::npos)
+			return;
+		std::size_t iterations{16};
+		double elapsed_ns{0.};
+		std::size_t bytes{0};
+		for (;;)
+		{
+			auto bytes_before = term_.total_bytes();
+			auto start = Clock::now();
+			for (std::size_t i{0}; i != iterations; ++i)
+				op(i);
+			auto end = Clock::now();
+			bytes = term_.total_bytes() - bytes_before;
+			elapsed_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+			if (elapsed_ns >= opts_.min_time_ms * 1e6 || iterations >= (std::size_t{1} << 30))
+				break;
+			iterations *= 2;
+		}
+		std::printf("{\"benchmark\":\"%s\",\"lines\":%d,\"cols\":%d,\"iterations\":%zu,\"ns_per_op\":%.1f",
+		            name, size.lines, size.cols, iterations, elapsed_ns / static_cast<double>(iterations));
+		if (frames)
+			std::printf(",\"bytes_per_frame\":%.1f", static_cast<double>(bytes) / static_cast<double>(iterations));
+		std::printf("}\n");
+		std::fflush(stdout);
+	}
+
+	private:
+	Options const& opts_;
+	nccpp::VirtualTerminal& term_;
+};
+
+// Baseline for the printw benchmarks : the formatting of ncurses itself
+int vw_mvprintw(nccpp::Window& win, int y, int x, char const* fmt, ...)
+{
+	if (wmove(win.get_handle(), y, x) == ERR)
+		return ERR;
+	va_list args;
+	va_start(args, fmt);
+	auto ret = vw_printw(win.get_handle(), fmt, args);
+	va_end(args);
+	return ret;
+}
+
+void bench_output(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	auto rows = static_cast<std::size_t>(size.lines);
+	std::string line(static_cast<std::size_t>(size.cols), 'x');
+	nccpp::String chline(static_cast<std::size_t>(size.cols), static_cast<chtype>('x') | A_BOLD);
+
+	runner.run("addstr", size, false, [&](std::size_t i){
+		win.mvaddstr(static_cast<int>(i % rows), 0, line);
+	});
+	runner.run("addchstr", size, false, [&](std::size_t i){
+		win.mvaddchstr(static_cast<int>(i % rows), 0, chline);
+	});
+	runner.run("printw", size, false, [&](std::size_t i){
+		win.mvprintw(static_cast<int>(i % rows), 0, "%8d %12.3f %s",
+		             static_cast<int>(i), static_cast<double>(i) * 0.5, "status");
+	});
+	runner.run("printw_vw", size, false, [&](std::size_t i){
+		vw_mvprintw(win, static_cast<int>(i % rows), 0, "%8d %12.3f %s",
+		            static_cast<int>(i), static_cast<double>(i) * 0.5, "status");
+	});
+	runner.run("printw_int", size, false, [&](std::size_t i){
+		auto n = static_cast<int>(i);
+		win.mvprintw(static_cast<int>(i % rows), 0, "cpu %d mem %d io %d net %d", n, n * 3, n * 7, -n);
+	});
+	runner.run("printw_int_vw", size, false, [&](std::size_t i){
+		auto n = static_cast<int>(i);
+		vw_mvprintw(win, static_cast<int>(i % rows), 0, "cpu %d mem %d io %d net %d", n, n * 3, n * 7, -n);
+	});
+	// Negative values printed with %u wrap around like with printf
+	runner.run("printw_unsigned", size, false, [&](std::size_t i){
+		auto n = static_cast<int>(i);
+		win.mvprintw(static_cast<int>(i % rows), 0, "id %u seq %u ofs %u", n, -n, static_cast<short>(-n));
+	});
+	runner.run("printw_unsigned_vw", size, false, [&](std::size_t i){
+		auto n = static_cast<int>(i);
+		vw_mvprintw(win, static_cast<int>(i % rows), 0, "id %u seq %u ofs %u", n, -n, static_cast<short>(-n));
+	});
+	runner.run("chgat", size, false, [&](std::size_t i){
+		auto c = static_cast<short>(i % 8);
+		win.mvchgat(static_cast<int>(i % rows), 0, size.cols, A_BOLD, nccpp::Color{c, nccpp::colors::black});
+	});
+
+	nccpp::Style styles[8];
+	for (short c{0}; c != 8; ++c)
+		styles[c] = nccpp::ncurses().make_style(A_BOLD, nccpp::Color{c, nccpp::colors::black});
+	runner.run("chgat_style", size, false, [&](std::size_t i){
+		win.mvchgat(static_cast<int>(i % rows), 0, size.cols, styles[i % 8]);
+	});
+
+	// A status line of 8 fields: label, then value
+	std::string const labels[]{"cpu ", "mem ", "io ", "net "};
+	std::string const values[]{"12% ", "3.2G ", "45M/s ", "1.1M/s "};
+	runner.run("styled_attron", size, false, [&](std::size_t i){
+		win.move(static_cast<int>(i % rows), 0);
+		for (short f{0}; f != 4; ++f)
+		{
+			win.attron(static_cast<int>(nccpp::ncurses().color_to_attr(nccpp::Color{7, 0})));
+			win.addstr(labels[f]);
+			win.attroff(static_cast<int>(nccpp::ncurses().color_to_attr(nccpp::Color{7, 0})));
+			win.attron(static_cast<int>(A_BOLD | nccpp::ncurses().color_to_attr(nccpp::Color{f, 0})));
+			win.addstr(values[f]);
+			win.attroff(static_cast<int>(A_BOLD | nccpp::ncurses().color_to_attr(nccpp::Color{f, 0})));
+		}
+	});
+	nccpp::Style const label_style{nccpp::ncurses().make_style(A_NORMAL, nccpp::Color{7, 0})};
+	std::vector<nccpp::StyledRun> runs;
+	for (short f{0}; f != 4; ++f)
+	{
+		runs.emplace_back(labels[f], label_style);
+		runs.emplace_back(values[f], nccpp::ncurses().make_style(A_BOLD, nccpp::Color{f, 0}));
+	}
+	runner.run("add_runs", size, false, [&](std::size_t i){
+		win.mvadd_runs(static_cast<int>(i % rows), 0, runs.data(), runs.size());
+	});
+}
+
+void bench_utf8(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	auto rows = static_cast<std::size_t>(size.lines);
+	std::string ascii(static_cast<std::size_t>(size.cols), 'x');
+	// 17 columns per repetition
+	std::string mixed;
+	for (int width{0}; width + 17 <= size.cols; width += 17)
+		mixed += "h\xC3\xA9llo w\xC3\xB6rld \xE2\x9C\x93 \xE6\x97\xA5 ";
+	std::vector<wchar_t> wide(mixed.size() + 1);
+
+	runner.run("addnstr_ascii", size, false, [&](std::size_t i){
+		win.mvaddnstr(static_cast<int>(i % rows), 0, ascii.data(), ascii.size());
+	});
+	runner.run("add_utf8_ascii", size, false, [&](std::size_t i){
+		win.mvadd_utf8(static_cast<int>(i % rows), 0, ascii.data(), ascii.size());
+	});
+	runner.run("addnstr_mixed", size, false, [&](std::size_t i){
+		win.mvaddnstr(static_cast<int>(i % rows), 0, mixed.data(), mixed.size());
+	});
+	runner.run("addnwstr_mixed", size, false, [&](std::size_t i){
+		auto n = std::mbstowcs(wide.data(), mixed.c_str(), wide.size());
+		mvwaddnwstr(win.get_handle(), static_cast<int>(i % rows), 0, wide.data(), static_cast<int>(n));
+	});
+	runner.run("add_utf8_mixed", size, false, [&](std::size_t i){
+		win.mvadd_utf8(static_cast<int>(i % rows), 0, mixed.data(), mixed.size());
+	});
+}
+
+void bench_blit(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	auto cols = static_cast<std::size_t>(size.cols);
+	std::vector<chtype> cells(static_cast<std::size_t>(size.lines) * cols);
+	for (std::size_t i{0}; i != cells.size(); ++i)
+		cells[i] = static_cast<chtype>('a' + i % 26) | (i % 3 ? A_NORMAL : A_BOLD);
+
+	// blit does the same per-row work, plus clipping, so both should be level
+	runner.run("addchnstr_rect", size, false, [&](std::size_t){
+		for (int y{0}; y != size.lines; ++y)
+			win.mvaddchnstr(y, 0, cells.data() + static_cast<std::size_t>(y) * cols, cols);
+	});
+	runner.run("blit", size, false, [&](std::size_t){
+		win.blit(0, 0, size.lines, size.cols, cells.data(), cols);
+	});
+	runner.run("blit_transparent", size, false, [&](std::size_t){
+		win.blit(0, 0, size.lines, size.cols, cells.data(), cols, static_cast<chtype>('e'));
+	});
+}
+
+void bench_refresh(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	std::string lines[2] = {std::string(static_cast<std::size_t>(size.cols), 'a'),
+	                        std::string(static_cast<std::size_t>(size.cols), 'b')};
+	auto fill = [&](std::size_t i){
+		for (int y{0}; y != size.lines; ++y)
+			win.mvaddstr(y, 0, lines[i % 2]);
+	};
+
+	fill(1);
+	runner.run("refresh_full", size, true, [&](std::size_t i){
+		fill(i);
+		win.refresh();
+	});
+	runner.run("refresh_one_line", size, true, [&](std::size_t i){
+		win.mvaddstr(static_cast<int>(i % static_cast<std::size_t>(size.lines)), 0, lines[i % 2]);
+		win.refresh();
+	});
+	runner.run("refresh_unchanged", size, true, [&](std::size_t){
+		win.refresh();
+	});
+}
+
+void bench_canvas(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	nccpp::Canvas canvas{win};
+	canvas.fill(static_cast<chtype>('a'));
+	canvas.refresh();
+
+	std::size_t frame{0};
+	runner.run("canvas_sparse", size, true, [&](std::size_t){
+		++frame;
+		for (std::size_t j{0}; j != 8; ++j)
+		{
+			auto cell = (frame * 8 + j) * 7919;
+			canvas.set(static_cast<int>(cell % static_cast<std::size_t>(size.lines)),
+			           static_cast<int>((cell / 3) % static_cast<std::size_t>(size.cols)),
+			           static_cast<chtype>('a' + frame % 26));
+		}
+		canvas.refresh();
+	});
+	runner.run("canvas_unchanged", size, true, [&](std::size_t){
+		canvas.refresh();
+	});
+}
+
+void bench_doupdate(Runner& runner, Size size)
+{
+	int half_lines{size.lines / 2}, half_cols{size.cols / 2};
+	std::vector<nccpp::Window> wins{};
+	wins.reserve(4);
+	for (int y{0}; y != 2; ++y)
+		for (int x{0}; x != 2; ++x)
+			wins.emplace_back(half_lines, half_cols, y * half_lines, x * half_cols);
+	std::string lines[2] = {std::string(static_cast<std::size_t>(half_cols), 'a'),
+	                        std::string(static_cast<std::size_t>(half_cols), 'b')};
+
+	runner.run("outrefresh_doupdate", size, true, [&](std::size_t i){
+		for (auto& win : wins)
+		{
+			for (int y{0}; y != half_lines; ++y)
+				win.mvaddstr(y, 0, lines[i % 2]);
+			win.outrefresh();
+		}
+		nccpp::ncurses().doupdate();
+	});
+	runner.run("refresh_each", size, true, [&](std::size_t i){
+		for (auto& win : wins)
+		{
+			for (int y{0}; y != half_lines; ++y)
+				win.mvaddstr(y, 0, lines[i % 2]);
+			win.refresh();
+		}
+	});
+
+	auto& scheduler = nccpp::ncurses().get_frame_scheduler();
+	scheduler.set_coalescing(true);
+	runner.run("scheduler_coalesced", size, true, [&](std::size_t i){
+		for (auto& win : wins)
+		{
+			for (int y{0}; y != half_lines; ++y)
+				win.mvaddstr(y, 0, lines[i % 2]);
+			win.refresh();
+		}
+		scheduler.flush_now();
+	});
+	scheduler.set_coalescing(false);
+}
+
+// Each iteration appends one line, so bytes_per_frame is the cost of an appended line.
+void bench_tail(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	std::size_t next{0};
+	auto log_line = [&]{
+		return "12:00:00.000 [worker-" + std::to_string(next % 8) + "] request " +
+		       std::to_string(next) + " served";
+	};
+
+	nccpp::TailView tail{win, 1024};
+	runner.run("tail_scroll", size, true, [&](std::size_t){
+		tail.append(log_line());
+		++next;
+		tail.refresh();
+	});
+	runner.run("tail_batch8", size, true, [&](std::size_t i){
+		tail.append(log_line());
+		++next;
+		if (i % 8 == 7)
+			tail.refresh();
+	});
+
+	// Without idlok, ncurses can't use the terminal scroll region.
+	nccpp::Window plain{size.lines, size.cols, 0, 0};
+	idlok(plain.get_handle(), FALSE);
+	std::vector<std::string> lines(static_cast<std::size_t>(size.lines));
+	runner.run("tail_full_redraw", size, true, [&](std::size_t){
+		std::rotate(lines.begin(), lines.begin() + 1, lines.end());
+		lines.back() = log_line();
+		++next;
+		for (int y{0}; y != size.lines; ++y)
+		{
+			plain.mvaddstr(y, 0, lines[static_cast<std::size_t>(y)]);
+			plain.clrtoeol();
+		}
+		plain.refresh();
+	});
+}
+
+void bench_draw_queue(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	nccpp::DrawQueue queue{};
+	std::string line(static_cast<std::size_t>(size.cols), 'x');
+
+	// One command per line of the window, each written twice, so half of them are merged.
+	runner.run("draw_queue_drain", size, false, [&](std::size_t){
+		for (int pass{0}; pass != 2; ++pass)
+			for (int y{0}; y != size.lines; ++y)
+				queue.push_text(win, y, 0, line);
+		queue.drain();
+	});
+}
+
+void bench_pad(Runner& runner, Size size)
+{
+	nccpp::PagedPad view{std::size_t{1} << 22, size.cols, size.lines * 3,
+	                     [](nccpp::Pad& pad, int y, std::size_t row){
+		                     pad.mvprintw(y, 0, "%zu %s", row, "lorem ipsum dolor sit amet");
+	                     }};
+	view.set_screen_area(0, 0, size.lines, size.cols);
+
+	runner.run("paged_pad_scroll", size, true, [&](std::size_t){
+		view.scroll_by(1, 0);
+		view.refresh();
+	});
+}
+
+void bench_subwindow(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	runner.run("subwindow", size, false, [&](std::size_t){
+		auto handle = win.add_subwindow(size.lines / 2, size.cols / 2, 1, 1);
+		win.delete_subwindow(handle);
+	});
+	// Popups opened and closed out of order, 16 of them alive at any time
+	std::vector<nccpp::SubwindowHandle> popups;
+	for (int i{0}; i != 16; ++i)
+		popups.push_back(win.add_subwindow(4, 10, i, i));
+	runner.run("subwindow_churn", size, false, [&](std::size_t i){
+		auto& popup = popups[(i * 7) % popups.size()];
+		win.delete_subwindow(popup);
+		popup = win.add_subwindow(4, 10, static_cast<int>(i % 16), static_cast<int>(i % 16));
+	});
+}
+
+// Dashboard of 9 subwindows: header, sidebar, 4 panes and footer.
+void bench_layout(Runner& runner, Size size)
+{
+	using nccpp::Constraint;
+	using Direction = nccpp::Layout::Direction;
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	auto build = [](nccpp::Layout& layout){
+		layout.add(layout.root(), Constraint::fixed(1));
+		auto body = layout.add(layout.root(), Constraint::fill(), Direction::row);
+		layout.add(layout.root(), Constraint::fixed(1));
+		auto sidebar = layout.add(body, Constraint::percentage(20));
+		auto main = layout.add(body, Constraint::fill());
+		for (int i{0}; i != 4; ++i)
+			layout.add(main, Constraint::fill());
+		return sidebar;
+	};
+	auto resize = [&](std::size_t i){
+		auto shrink = static_cast<int>(i % 2);
+		wresize(win.get_handle(), size.lines - shrink, size.cols - shrink);
+	};
+
+	{
+		nccpp::Layout layout{win};
+		auto sidebar = build(layout);
+		layout.apply();
+		runner.run("layout_unchanged", size, false, [&](std::size_t){
+			layout.apply();
+		});
+		// Only the body subtree is visited
+		runner.run("layout_sidebar", size, false, [&](std::size_t i){
+			layout.set_constraint(sidebar, Constraint::percentage(i % 2 ? 25 : 20));
+			layout.apply();
+		});
+		// The root alternates between two sizes
+		runner.run("layout_resize", size, false, [&](std::size_t i){
+			resize(i);
+			layout.apply();
+		});
+	}
+	runner.run("layout_recreate", size, false, [&](std::size_t i){
+		resize(i);
+		nccpp::Layout layout{win};
+		build(layout);
+		layout.apply();
+	});
+}
+
+// Snapshots are written to /tmp, the row by row read-back through inchnstr is the baseline.
+void bench_snapshot(Runner& runner, Size size)
+{
+	nccpp::Window win{size.lines, size.cols, 0, 0};
+	for (int y{0}; y != size.lines; ++y)
+		for (int x{0}; x != size.cols; ++x)
+			win.mvaddch(y, x, static_cast<chtype>('a' + (x + y) % 26) | (x % 7 ? A_NORMAL : A_BOLD));
+	auto prefix = "/tmp/nccpp_bench_" + std::to_string(getpid());
+	auto base = prefix + ".snap", delta = prefix + ".delta";
+
+	nccpp::String row;
+	runner.run("inchnstr_dump", size, false, [&](std::size_t){
+		for (int y{0}; y != size.lines; ++y)
+			win.mvinchnstr(y, 0, row, static_cast<std::size_t>(size.cols));
+	});
+	runner.run("snapshot_save", size, false, [&](std::size_t){
+		win.save(base);
+	});
+	runner.run("snapshot_load", size, false, [&](std::size_t){
+		win.load(base);
+	});
+	// One line differs from the base
+	runner.run("snapshot_save_delta", size, false, [&](std::size_t i){
+		win.mvaddstr(size.lines / 2, 0, i % 2 ? "odd" : "even");
+		win.save(delta, base);
+	});
+	runner.run("snapshot_restore_delta", size, false, [&](std::size_t){
+		win.load(base);
+		win.load(delta);
+	});
+	std::remove(base.c_str());
+	std::remove(delta.c_str());
+}
+
+// Each iteration pastes 256 characters and reads them back.
+void bench_input(Runner& runner)
+{
+	auto& nc = nccpp::ncurses();
+	auto& term = *nc.get_virtual_terminal();
+	std::string paste(256, 'p');
+	nc.nodelay(true);
+
+	runner.run("getch_paste", Size{0, 0}, false, [&](std::size_t){
+		term.send_input(paste);
+		while (nc.getch() != ERR)
+			;
+	});
+	nccpp::Event events[64];
+	runner.run("read_events_paste", Size{0, 0}, false, [&](std::size_t){
+		term.send_input(paste);
+		while (nc.read_events(events) != 0)
+			;
+	});
+	nc.nodelay(false);
+}
+
+// Screens writing to /dev/null, each with a window redrawn by the pool at every frame.
+void bench_screens(Runner& runner)
+{
+	struct Client
+	{
+		std::FILE* out;
+		std::FILE* in;
+		std::unique_ptr<nccpp::Screen> screen;
+		std::unique_ptr<nccpp::Window> win;
+	};
+	std::vector<Client> clients;
+	for (int i{0}; i != 16; ++i)
+	{
+		auto out = std::fopen("/dev/null", "w"), in = std::fopen("/dev/null", "r");
+		if (!out || !in)
+			break;
+		clients.push_back(Client{out, in, nullptr, nullptr});
+		clients.back().screen.reset(new nccpp::Screen{out, in, "xterm-256color"});
+		clients.back().win.reset(new nccpp::Window{24, 80, 0, 0});
+	}
+
+	runner.run("screen_switch", Size{24, 80}, false, [&](std::size_t i){
+		clients[i % clients.size()].screen->make_current();
+	});
+
+	std::size_t frame{0};
+	auto render = [&](char const* name, std::size_t threads){
+		nccpp::ScreenPool pool{threads};
+		for (auto& client : clients)
+		{
+			auto& win = *client.win;
+			pool.add(*client.screen, [&win, &frame](nccpp::Screen&, nccpp::DrawQueue& queue){
+				for (int y{0}; y != 24; ++y)
+					queue.push_text(win, y, 0, "line " + std::to_string(y) + " of frame " + std::to_string(frame));
+				queue.push_refresh(win);
+			});
+		}
+		runner.run(name, Size{24, 80}, false, [&](std::size_t){
+			++frame;
+			pool.render();
+		});
+	};
+	render("screen_pool_render_1", 1);
+	render("screen_pool_render", 0);
+
+	for (auto& client : clients)
+	{
+		client.screen->make_current();
+		client.win.reset();
+		client.screen.reset();
+		std::fclose(client.out);
+		std::fclose(client.in);
+	}
+	nccpp::ncurses().make_current();
+}
+
+void bench_colors(Runner& runner)
+{
+	auto& nc = nccpp::ncurses();
+	nc.start_color();
+	runner.run("color_to_pair_number", Size{0, 0}, false, [&](std::size_t i){
+		auto fg = static_cast<short>(i % 8), bg = static_cast<short>((i / 8) % 8);
+		nc.color_to_pair_number(nccpp::Color{fg, bg});
+	});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options opts{"", 200., "xterm-256color"};
+	for (int i{1}; i < argc; ++i)
+	{
+		std::string arg{argv[i]};
+		if (arg == "--filter" && i + 1 < argc)
+			opts.filter = argv[++i];
+		else if (arg == "--min-time-ms" && i + 1 < argc)
+			opts.min_time_ms = std::atof(argv[++i]);
+		else if (arg == "--term" && i + 1 < argc)
+			opts.term = argv[++i];
+		else
+		{
+			std::fprintf(stderr, "Usage : %s [--filter substring] [--min-time-ms ms] [--term name]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// add_utf8 and the wide-character functions need a UTF-8 locale
+	if (!std::setlocale(LC_ALL, "C.UTF-8"))
+		std::setlocale(LC_ALL, "");
+
+	Size const sizes[] = {{24, 80}, {50, 160}, {100, 300}};
+	nccpp::use_virtual_terminal(sizes[2].lines, sizes[2].cols, opts.term);
+	auto& nc = nccpp::ncurses();
+	Runner runner{opts, *nc.get_virtual_terminal()};
+
+	bench_colors(runner);
+	bench_input(runner);
+	bench_screens(runner);
+	for (auto size : sizes)
+	{
+		bench_output(runner, size);
+		bench_utf8(runner, size);
+		bench_blit(runner, size);
+		bench_refresh(runner, size);
+		bench_canvas(runner, size);
+		bench_doupdate(runner, size);
+		bench_tail(runner, size);
+		bench_draw_queue(runner, size);
+		bench_pad(runner, size);
+		bench_subwindow(runner, size);
+		bench_layout(runner, size);
+		bench_snapshot(runner, size);
+	}
+	return EXIT_SUCCESS;
+}
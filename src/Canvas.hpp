@@ -0,0 +1,128 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file Canvas.hpp
+ * \brief Header file for the Canvas class.
+ */
+
+#ifndef NCURSESCPP_CANVAS_HPP_
+#define NCURSESCPP_CANVAS_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Statistics about the last Canvas::flush() call.
+ */
+struct CanvasStats
+{
+	std::size_t changed_cells; ///< Number of cells which differed from the previous frame.
+	std::size_t changed_spans; ///< Number of waddchnstr calls issued.
+	std::size_t changed_lines; ///< Number of lines containing at least one changed cell.
+};
+
+/**
+ * \brief Double-buffered drawing surface over a Window.
+ * 
+ * Drawing is done in a back buffer. flush() compares it with the front buffer, which holds
+ * what was last sent to the window, and only writes the spans of cells which changed.
+ * The canvas assumes it is the only thing writing to the window. If something else draws in
+ * it, call invalidate() so that the next flush() rewrites every cell.
+ */
+class Canvas
+{
+	public:
+	explicit Canvas(Window&);
+
+	/// \cond NODOC
+	Canvas(Canvas const&) = delete;
+	Canvas& operator=(Canvas const&) = delete;
+
+	Canvas(Canvas&&) = default;
+	Canvas& operator=(Canvas&&) = delete;
+	/// \endcond
+
+	~Canvas() = default;
+
+	Window& get_window();
+
+	int line_count() const;
+	int column_count() const;
+
+	chtype* row(int);
+	chtype const* row(int) const;
+	chtype get(int, int) const;
+	void set(int, int, chtype);
+	void fill(chtype);
+
+	void resize();
+	void invalidate();
+
+	int flush();
+	int refresh();
+	int outrefresh();
+
+	CanvasStats const& last_flush_stats() const;
+
+	private:
+	Window& win_;
+	int lines_;
+	int cols_;
+	std::vector<chtype> back_;
+	std::vector<chtype> front_;
+	bool full_redraw_;
+	CanvasStats stats_;
+
+	int write_span_(int, int, int);
+};
+
+} // namespace nccpp
+
+#include "Canvas.ipp"
+
+#endif // Header guard
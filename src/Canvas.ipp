@@ -0,0 +1,312 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+#ifndef NCURSESCPP_CANVAS_IPP_
+#define NCURSESCPP_CANVAS_IPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace nccpp
+{
+
+/// \cond NODOC
+namespace internal
+{
+
+// Changed spans separated by fewer unchanged cells than this are merged, since rewriting a few
+// identical cells is cheaper than an additional wmove and waddchnstr.
+constexpr int canvas_merge_gap = 4;
+
+} // namespace internal
+/// \endcond
+
+/**
+ * \brief Create a canvas covering a window.
+ * 
+ * The canvas has the size of the window and is filled with blanks. The first flush()
+ * writes every cell.
+ * 
+ * \param win The window to draw into. It must outlive the canvas.
+ * \pre The Window manages a ncurses window.
+ */
+inline Canvas::Canvas(Window& win)
+	: win_{win}, lines_{0}, cols_{0}, back_{}, front_{}, full_redraw_{true}, stats_{0, 0, 0}
+{
+	(this->resize)();
+}
+
+/**
+ * \brief Get the window the canvas draws into.
+ * 
+ * \return The window.
+ */
+inline Window& Canvas::get_window()
+{
+	return win_;
+}
+
+/**
+ * \brief Get the number of lines of the canvas.
+ * 
+ * \return The number of lines.
+ */
+inline int Canvas::line_count() const
+{
+	return lines_;
+}
+
+/**
+ * \brief Get the number of columns of the canvas.
+ * 
+ * \return The number of columns.
+ */
+inline int Canvas::column_count() const
+{
+	return cols_;
+}
+
+/**
+ * \brief Get a line of the back buffer.
+ * 
+ * \param y Index of the line.
+ * \pre 0 <= y < line_count()
+ * \return Pointer to the column_count() cells of the line.
+ */
+inline chtype* Canvas::row(int y)
+{
+	assert(y >= 0 && y < lines_ && "Line out of canvas");
+	return back_.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(cols_);
+}
+
+/**
+ * \brief Get a line of the back buffer.
+ * 
+ * \param y Index of the line.
+ * \pre 0 <= y < line_count()
+ * \return Pointer to the column_count() cells of the line.
+ */
+inline chtype const* Canvas::row(int y) const
+{
+	assert(y >= 0 && y < lines_ && "Line out of canvas");
+	return back_.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(cols_);
+}
+
+/**
+ * \brief Get a cell of the back buffer.
+ * 
+ * \param y,x Position of the cell.
+ * \pre The position is inside the canvas.
+ * \return The character and attributes of the cell.
+ */
+inline chtype Canvas::get(int y, int x) const
+{
+	assert(x >= 0 && x < cols_ && "Column out of canvas");
+	return (this->row)(y)[x];
+}
+
+/**
+ * \brief Set a cell of the back buffer.
+ * 
+ * A null character ends its span when flushed, as with Window::addchnstr.
+ * 
+ * \param y,x Position of the cell.
+ * \param ch The character and attributes of the cell.
+ * \pre The position is inside the canvas.
+ */
+inline void Canvas::set(int y, int x, chtype ch)
+{
+	assert(x >= 0 && x < cols_ && "Column out of canvas");
+	(this->row)(y)[x] = ch;
+}
+
+/**
+ * \brief Fill the back buffer.
+ * 
+ * \param ch The character and attributes to fill the canvas with.
+ */
+inline void Canvas::fill(chtype ch)
+{
+	std::fill(back_.begin(), back_.end(), ch);
+}
+
+/**
+ * \brief Resize the canvas to the current size of its window.
+ * 
+ * The contents of the back buffer are kept where they overlap the new size, and the next
+ * flush() writes every cell.
+ * 
+ * \pre The Window manages a ncurses window.
+ */
+inline void Canvas::resize()
+{
+	int lines{0}, cols{0};
+	win_.get_maxyx(lines, cols);
+	if (lines != lines_ || cols != cols_)
+	{
+		std::vector<chtype> back(static_cast<std::size_t>(lines) * static_cast<std::size_t>(cols),
+		                         static_cast<chtype>(' '));
+		int common_cols{std::min(cols, cols_)};
+		for (int y{0}; y < std::min(lines, lines_); ++y)
+			std::copy_n((this->row)(y), common_cols,
+			            back.begin() + static_cast<std::ptrdiff_t>(y) * cols);
+		back_.swap(back);
+		front_.assign(back_.size(), 0);
+		lines_ = lines;
+		cols_ = cols;
+	}
+	(this->invalidate)();
+}
+
+/**
+ * \brief Make the next flush() write every cell.
+ */
+inline void Canvas::invalidate()
+{
+	full_redraw_ = true;
+}
+
+/**
+ * \brief Write the cells which changed since the last flush to the window.
+ * 
+ * Each line is first compared as a whole with memcmp, then the differing spans are located
+ * and written with one waddchnstr call each. Only the written part of each line is marked as
+ * changed in the window. The window isn't refreshed and its cursor position is left unchanged.
+ * 
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Canvas::flush()
+{
+	WINDOW* win{win_.get_handle()};
+	assert(win && "Window doesn't manage any object");
+	int cur_y{getcury(win)}, cur_x{getcurx(win)};
+	auto row_size = static_cast<std::size_t>(cols_) * sizeof(chtype);
+	stats_ = CanvasStats{0, 0, 0};
+	int ret{OK};
+
+	for (int y{0}; y != lines_; ++y)
+	{
+		chtype const* back{(this->row)(y)};
+		chtype const* front{front_.data() + (back - back_.data())};
+		if (full_redraw_)
+		{
+			if (cols_ != 0 && (this->write_span_)(y, 0, cols_) == ERR)
+				ret = ERR;
+			stats_.changed_cells += static_cast<std::size_t>(cols_);
+			++stats_.changed_lines;
+			continue;
+		}
+		if (std::memcmp(back, front, row_size) == 0)
+			continue;
+
+		++stats_.changed_lines;
+		int first{static_cast<int>(std::mismatch(back, back + cols_, front).first - back)};
+		while (first != cols_)
+		{
+			int last{first};
+			for (;;)
+			{
+				while (last != cols_ && back[last] != front[last])
+				{
+					++last;
+					++stats_.changed_cells;
+				}
+				auto next = static_cast<int>(std::mismatch(back + last, back + cols_, front + last).first - back);
+				if (next == cols_ || next - last >= internal::canvas_merge_gap)
+				{
+					if ((this->write_span_)(y, first, last - first) == ERR)
+						ret = ERR;
+					first = next;
+					break;
+				}
+				last = next;
+			}
+		}
+	}
+
+	full_redraw_ = false;
+	wmove(win, cur_y, cur_x);
+	return ret;
+}
+
+/**
+ * \brief Flush the canvas and refresh its window.
+ * 
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Canvas::refresh()
+{
+	return (this->flush)() == ERR ? ERR : win_.refresh();
+}
+
+/**
+ * \brief Flush the canvas and call wnoutrefresh for its window.
+ * 
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Canvas::outrefresh()
+{
+	return (this->flush)() == ERR ? ERR : win_.outrefresh();
+}
+
+/**
+ * \brief Get statistics about the last flush.
+ * 
+ * \return The number of changed cells, spans and lines of the last flush.
+ */
+inline CanvasStats const& Canvas::last_flush_stats() const
+{
+	return stats_;
+}
+
+/// \cond NODOC
+inline int Canvas::write_span_(int y, int x, int n)
+{
+	auto offset = static_cast<std::size_t>(y) * static_cast<std::size_t>(cols_) + static_cast<std::size_t>(x);
+	std::copy_n(back_.data() + offset, n, front_.data() + offset);
+	++stats_.changed_spans;
+	NCCPP_RECORD_OUTPUT(win_, addchstr, static_cast<std::size_t>(n));
+	WINDOW* win{win_.get_handle()};
+	return wmove(win, y, x) == ERR || waddchnstr(win, back_.data() + offset, n) == ERR ? ERR : OK;
+}
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
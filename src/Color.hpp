@@ -41,6 +41,9 @@
 #ifndef NCURSESCPP_COLOR_HPP_
 #define NCURSESCPP_COLOR_HPP_
 
+#include <cstddef>
+#include <functional>
+
 namespace nccpp
 {
 
@@ -49,8 +52,8 @@ namespace nccpp
  */
 struct Color
 {
-	Color() : Color{-1, -1} {}
-	Color(short f, short b) : foreground{f}, background{b} {}
+	constexpr Color() : Color{-1, -1} {}
+	constexpr Color(short f, short b) : foreground{f}, background{b} {}
 
 	short foreground; ///< Foreground color.
 	short background; ///< Background color.
@@ -68,5 +71,23 @@ inline bool operator!=(nccpp::Color const& lhs, nccpp::Color const& rhs)
 
 } // namespace nccpp
 
+namespace std
+{
+
+/**
+ * \brief Hash specialization allowing Color to be used as an unordered container key.
+ */
+template <>
+struct hash<nccpp::Color>
+{
+	std::size_t operator()(nccpp::Color const& color) const noexcept
+	{
+		auto fg = static_cast<unsigned short>(color.foreground);
+		auto bg = static_cast<unsigned short>(color.background);
+		return std::hash<unsigned int>{}((static_cast<unsigned int>(fg) << 16) | bg);
+	}
+};
+
+} // namespace std
 
 #endif //Header guard
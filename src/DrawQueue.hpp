@@ -0,0 +1,180 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file DrawQueue.hpp
+ * \brief Header file for the DrawQueue class.
+ */
+
+#ifndef NCURSESCPP_DRAWQUEUE_HPP_
+#define NCURSESCPP_DRAWQUEUE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Counters describing the behaviour of a DrawQueue.
+ */
+struct DrawQueueStats
+{
+	std::size_t enqueued;                ///< Commands pushed by any thread.
+	std::size_t applied;                 ///< Commands applied by drain().
+	std::size_t merged;                  ///< Commands dropped because a later command overwrote them.
+	std::size_t drains;                  ///< Calls to drain() which found at least one command.
+	std::size_t max_depth;               ///< Largest number of pending commands seen by drain().
+	std::chrono::nanoseconds max_latency;   ///< Longest delay between a push and the drain handling it.
+	std::chrono::nanoseconds total_latency; ///< Sum of those delays, to compute an average.
+};
+
+/**
+ * \brief Queue of draw commands, filled by any thread and applied by the thread owning ncurses.
+ * 
+ * Producers push commands aimed at windows without taking any lock : the queue is a
+ * multiple-producer single-consumer linked list, where pushing is a single atomic exchange.
+ * The UI thread calls drain() to apply the pending commands in a batch. Within a batch, text
+ * overwritten by a later command of the same batch, or erased by a later erase of the same
+ * window, is dropped, and the refresh requests result in a single screen update.
+ * 
+ * The windows must outlive the commands aimed at them.
+ */
+class DrawQueue
+{
+	public:
+	/// Clock used to measure the drain latency.
+	using Clock = std::chrono::steady_clock;
+
+	DrawQueue();
+
+	/// \cond NODOC
+	DrawQueue(DrawQueue const&) = delete;
+	DrawQueue& operator=(DrawQueue const&) = delete;
+
+	DrawQueue(DrawQueue&&) = delete;
+	DrawQueue& operator=(DrawQueue&&) = delete;
+	/// \endcond
+
+	~DrawQueue();
+
+	// Producers
+
+	void push_text(Window&, int, int, std::string);
+	void push_text(Window&, int, int, std::string, attr_t);
+	void push_styled(Window&, int, int, String);
+	void push_erase(Window&);
+	void push_refresh(Window&);
+
+	// Consumer
+
+	std::size_t drain(std::size_t = std::numeric_limits<std::size_t>::max());
+
+	std::size_t depth() const;
+	DrawQueueStats queue_stats() const;
+	void reset_queue_stats();
+
+	private:
+	/// \cond NODOC
+	enum class Op
+	{
+		text,
+		styled,
+		erase,
+		refresh
+	};
+
+	struct Command
+	{
+		Op op;
+		Window* win;
+		int y;
+		int x;
+		// Number of cells covered by a text command, or -1 if unknown.
+		int cells;
+		attr_t attrs;
+		// A text command printed with the attributes of the window when the queue is drained.
+		bool window_attrs;
+		std::string text;
+		String chtext;
+		Clock::time_point pushed_at;
+	};
+
+	struct Node
+	{
+		std::atomic<Node*> next;
+		Command cmd;
+	};
+	/// \endcond
+
+	std::atomic<Node*> head_;
+	Node* tail_;
+	std::atomic<std::size_t> enqueued_;
+	std::atomic<std::size_t> dequeued_;
+	std::vector<Command> batch_;
+	std::vector<bool> dropped_;
+	std::vector<Window*> refreshed_;
+	std::vector<Screen*> updated_;
+	DrawQueueStats stats_;
+
+	void push_(Command&&);
+	void push_text_(Window&, int, int, std::string, attr_t, bool);
+	bool pop_(Command&);
+	void merge_batch_();
+	void apply_(Command const&);
+};
+
+} // namespace nccpp
+
+#ifndef NCCPP_DRAWQUEUE_NOIMPL
+#include "Ncurses.hpp"
+
+#include "DrawQueue.ipp"
+#endif
+
+#endif // Header guard
@@ -0,0 +1,388 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+#ifndef NCURSESCPP_DRAWQUEUE_IPP_
+#define NCURSESCPP_DRAWQUEUE_IPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+namespace nccpp
+{
+
+/**
+ * \brief Create an empty queue.
+ */
+inline DrawQueue::DrawQueue()
+	: head_{nullptr}, tail_{new Node{}}, enqueued_{0}, dequeued_{0}, batch_{}, dropped_{}, refreshed_{},
+	  updated_{}, stats_{0, 0, 0, 0, 0, std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero()}
+{
+	tail_->next.store(nullptr, std::memory_order_relaxed);
+	head_.store(tail_, std::memory_order_relaxed);
+}
+
+/**
+ * \brief Destroy the queue, dropping the pending commands.
+ * 
+ * \pre No thread is pushing commands.
+ */
+inline DrawQueue::~DrawQueue()
+{
+	while (tail_)
+	{
+		Node* next{tail_->next.load(std::memory_order_acquire)};
+		delete tail_;
+		tail_ = next;
+	}
+}
+
+/**
+ * \brief Queue a string to print with the attributes of the window.
+ * 
+ * The string is printed with the attributes and color pair the window has when the queue is drained.
+ * This function can be called from any thread.
+ * 
+ * \param win The window to print into.
+ * \param y,x Position of the string.
+ * \param text The string to print.
+ */
+inline void DrawQueue::push_text(Window& win, int y, int x, std::string text)
+{
+	(this->push_text_)(win, y, x, std::move(text), A_NORMAL, true);
+}
+
+/**
+ * \brief Queue a string to print with given attributes.
+ * 
+ * The attributes of the window are restored once the string is printed.
+ * This function can be called from any thread.
+ * 
+ * \param win The window to print into.
+ * \param y,x Position of the string.
+ * \param text The string to print.
+ * \param attrs Attributes, including the color pair, to print the string with. A_NORMAL prints it
+ * without any attribute.
+ */
+inline void DrawQueue::push_text(Window& win, int y, int x, std::string text, attr_t attrs)
+{
+	(this->push_text_)(win, y, x, std::move(text), attrs, false);
+}
+
+/**
+ * \brief Queue a string of characters with attributes to print, as with Window::addchstr.
+ * 
+ * This function can be called from any thread.
+ * 
+ * \param win The window to print into.
+ * \param y,x Position of the string.
+ * \param chtext The characters to print.
+ */
+inline void DrawQueue::push_styled(Window& win, int y, int x, String chtext)
+{
+	auto cells = static_cast<int>(std::find(chtext.begin(), chtext.end(), chtype{0}) - chtext.begin());
+	(this->push_)(Command{Op::styled, &win, y, x, cells, A_NORMAL, false, std::string{}, std::move(chtext), Clock::now()});
+}
+
+/**
+ * \brief Queue an erase of a window, as with Window::erase.
+ * 
+ * This function can be called from any thread.
+ * 
+ * \param win The window to erase.
+ */
+inline void DrawQueue::push_erase(Window& win)
+{
+	(this->push_)(Command{Op::erase, &win, 0, 0, 0, A_NORMAL, false, std::string{}, String{}, Clock::now()});
+}
+
+/**
+ * \brief Queue a refresh of a window.
+ * 
+ * All the refreshes applied by a drain are done with a single screen update.
+ * This function can be called from any thread.
+ * 
+ * \param win The window to refresh.
+ */
+inline void DrawQueue::push_refresh(Window& win)
+{
+	(this->push_)(Command{Op::refresh, &win, 0, 0, 0, A_NORMAL, false, std::string{}, String{}, Clock::now()});
+}
+
+/**
+ * \brief Apply the pending commands.
+ * 
+ * The commands are applied in the order they were pushed, except for the ones overwritten by a
+ * later command of the batch, which are dropped. The refreshed windows are copied to the virtual
+ * screen with wnoutrefresh, followed by a single doupdate of each screen they belong to. The windows
+ * of a screen whose frame scheduler coalesces refreshes are scheduled instead.
+ * 
+ * \param max Maximum number of commands to handle.
+ * \pre This function is only called by the thread using ncurses.
+ * \pre %Ncurses mode is on.
+ * \return The number of commands handled, including the dropped ones.
+ */
+inline std::size_t DrawQueue::drain(std::size_t max)
+{
+	auto depth = (this->depth)();
+	batch_.clear();
+	Command cmd{};
+	while (batch_.size() != max && (this->pop_)(cmd))
+		batch_.push_back(std::move(cmd));
+	if (batch_.empty())
+		return 0;
+
+	auto now = Clock::now();
+	++stats_.drains;
+	stats_.max_depth = std::max(stats_.max_depth, depth);
+	for (auto const& c : batch_)
+	{
+		auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - c.pushed_at);
+		stats_.max_latency = std::max(stats_.max_latency, latency);
+		stats_.total_latency += latency;
+	}
+
+	(this->merge_batch_)();
+	refreshed_.clear();
+	for (std::size_t i{0}; i != batch_.size(); ++i)
+		if (!dropped_[i])
+			(this->apply_)(batch_[i]);
+
+	updated_.clear();
+	for (auto win : refreshed_)
+	{
+		auto& screen = win->get_owning_screen();
+		auto& scheduler = screen.get_frame_scheduler();
+		// The scheduler only knows plain windows, pads are drawn by their outrefresh override
+		if (scheduler.is_coalescing() && !is_pad(win->get_handle()))
+			scheduler.schedule(*win);
+		else
+		{
+			win->outrefresh();
+			if (std::find(updated_.begin(), updated_.end(), &screen) == updated_.end())
+				updated_.push_back(&screen);
+		}
+	}
+	for (auto screen : updated_)
+		screen->doupdate();
+	return batch_.size();
+}
+
+/**
+ * \brief Get the number of pending commands.
+ * 
+ * This function can be called from any thread. The result is approximate while commands are
+ * being pushed or drained.
+ * 
+ * \return The number of commands pushed but not drained yet.
+ */
+inline std::size_t DrawQueue::depth() const
+{
+	auto dequeued = dequeued_.load(std::memory_order_acquire);
+	auto enqueued = enqueued_.load(std::memory_order_acquire);
+	return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+/**
+ * \brief Get the queue counters.
+ * 
+ * \pre This function is only called by the thread draining the queue.
+ * \return The counters accumulated since the creation of the queue or the last reset.
+ */
+inline DrawQueueStats DrawQueue::queue_stats() const
+{
+	auto stats = stats_;
+	stats.enqueued = enqueued_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+/**
+ * \brief Reset the queue counters drain() accumulates.
+ * 
+ * The number of enqueued commands isn't reset, since it is needed to compute the depth.
+ * 
+ * \pre This function is only called by the thread draining the queue.
+ */
+inline void DrawQueue::reset_queue_stats()
+{
+	stats_ = DrawQueueStats{0, 0, 0, 0, 0, std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero()};
+}
+
+/// \cond NODOC
+// Vyukov's intrusive MPSC queue : head_ is the last pushed node, tail_ a node whose command has
+// already been consumed, initially a stub.
+inline void DrawQueue::push_(Command&& cmd)
+{
+	Node* node{new Node{}};
+	node->next.store(nullptr, std::memory_order_relaxed);
+	node->cmd = std::move(cmd);
+	enqueued_.fetch_add(1, std::memory_order_release);
+	Node* prev{head_.exchange(node, std::memory_order_acq_rel)};
+	prev->next.store(node, std::memory_order_release);
+}
+
+inline bool DrawQueue::pop_(Command& cmd)
+{
+	Node* next{tail_->next.load(std::memory_order_acquire)};
+	if (!next)
+		return false;
+	cmd = std::move(next->cmd);
+	delete tail_;
+	tail_ = next;
+	dequeued_.fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+// Walk the batch backwards, remembering the erased windows and the spans written on each line,
+// and drop the text commands entirely covered by what was already seen.
+inline void DrawQueue::merge_batch_()
+{
+	dropped_.assign(batch_.size(), false);
+	if (batch_.size() < 2)
+		return;
+
+	std::vector<Window*> erased{};
+	std::unordered_map<std::uint64_t, std::vector<std::pair<int, int>>> spans{};
+	std::vector<Window*> windows{};
+	auto line_key = [&](Command const& c){
+		auto it = std::find(windows.begin(), windows.end(), c.win);
+		if (it == windows.end())
+			it = windows.insert(it, c.win);
+		auto index = static_cast<std::uint64_t>(it - windows.begin());
+		return (index << 32) | static_cast<std::uint32_t>(c.y);
+	};
+	auto forget_window = [&](Window* win){
+		auto it = std::find(windows.begin(), windows.end(), win);
+		if (it == windows.end())
+			return;
+		auto index = static_cast<std::uint64_t>(it - windows.begin());
+		for (auto span = spans.begin(); span != spans.end();)
+			if (span->first >> 32 == index)
+				span = spans.erase(span);
+			else
+				++span;
+	};
+
+	for (auto i = batch_.size(); i-- != 0;)
+	{
+		auto const& c = batch_[i];
+		if (c.op == Op::erase)
+			erased.push_back(c.win);
+		if (c.op != Op::text && c.op != Op::styled)
+			continue;
+		if (std::find(erased.begin(), erased.end(), c.win) != erased.end())
+		{
+			dropped_[i] = true;
+			continue;
+		}
+		WINDOW* win{c.win->get_handle()};
+		int height{getmaxy(win)}, width{getmaxx(win)};
+		if (c.y < 0 || c.y >= height || c.x < 0 || c.x >= width)
+			continue; // Nothing is written
+		int begin{c.x}, end{c.x + c.cells};
+		if (c.op == Op::styled)
+			// waddchnstr stops at the right edge
+			end = std::min(end, width);
+		else if (c.cells < 0 || end > width || (end == width && c.y == height - 1))
+		{
+			// waddnstr may wrap, and scroll the window from its bottom line : the span isn't known,
+			// and what the earlier commands wrote may be moved from under the spans already seen
+			if (is_scrollok(win))
+				forget_window(c.win);
+			continue;
+		}
+		auto& line = spans[line_key(c)];
+		if (std::any_of(line.begin(), line.end(),
+		                [=](std::pair<int, int> s){ return s.first <= begin && s.second >= end; }))
+			dropped_[i] = true;
+		else
+			line.emplace_back(begin, end);
+	}
+	stats_.merged += static_cast<std::size_t>(std::count(dropped_.begin(), dropped_.end(), true));
+}
+
+inline void DrawQueue::push_text_(Window& win, int y, int x, std::string text, attr_t attrs, bool window_attrs)
+{
+	// Only printable ASCII strings are known to cover one cell per byte.
+	int cells{static_cast<int>(text.size())};
+	for (auto c : text)
+		if (static_cast<unsigned char>(c) < 0x20 || static_cast<unsigned char>(c) >= 0x7f)
+		{
+			cells = -1;
+			break;
+		}
+	(this->push_)(Command{Op::text, &win, y, x, cells, attrs, window_attrs, std::move(text), String{},
+	                      Clock::now()});
+}
+
+inline void DrawQueue::apply_(Command const& c)
+{
+	WINDOW* win{c.win->get_handle()};
+	switch (c.op)
+	{
+		case Op::text:
+			if (!c.window_attrs)
+			{
+				attr_t old_attrs{};
+				short old_pair{};
+				wattr_get(win, &old_attrs, &old_pair, nullptr);
+				wattrset(win, static_cast<int>(c.attrs));
+				mvwaddnstr(win, c.y, c.x, c.text.data(), static_cast<int>(c.text.size()));
+				wattr_set(win, old_attrs, old_pair, nullptr);
+			}
+			else
+				mvwaddnstr(win, c.y, c.x, c.text.data(), static_cast<int>(c.text.size()));
+			break;
+		case Op::styled:
+			mvwaddchnstr(win, c.y, c.x, c.chtext.data(), static_cast<int>(c.chtext.size()));
+			break;
+		case Op::erase:
+			werase(win);
+			break;
+		case Op::refresh:
+			if (std::find(refreshed_.begin(), refreshed_.end(), c.win) == refreshed_.end())
+				refreshed_.push_back(c.win);
+			break;
+	}
+	++stats_.applied;
+}
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -0,0 +1,86 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file Event.hpp
+ * \brief Header file for the Event structure used by Window::read_events.
+ */
+
+#ifndef NCURSESCPP_EVENT_HPP_
+#define NCURSESCPP_EVENT_HPP_
+
+#ifndef NCURSES_NOMACROS
+#define NCURSES_NOMACROS
+#endif
+
+#ifndef NCURSES_WIDECHAR
+#define NCURSES_WIDECHAR 1
+#endif
+
+#include <ncurses.h>
+
+namespace nccpp
+{
+
+/**
+ * \brief Input event, as read by Window::read_events.
+ * 
+ * The meaningful members depend on the type of the event.
+ */
+struct Event
+{
+	/**
+	 * \brief Type of an event.
+	 */
+	enum class Type
+	{
+		key,          ///< A character or a special key, in *key*.
+		function_key, ///< A function key, whose number is in *function*.
+		mouse,        ///< A mouse event, in *mouse*.
+		resize        ///< A terminal resize, to *lines* x *cols*.
+	};
+
+	Type type;    ///< Type of the event.
+	int key;      ///< The value returned by getch, KEY_MOUSE and KEY_RESIZE included.
+	int function; ///< Number of the function key, for function_key events.
+	MEVENT mouse; ///< The event returned by getmouse, for mouse events.
+	int lines;    ///< Number of lines of the terminal, for resize events.
+	int cols;     ///< Number of columns of the terminal, for resize events.
+};
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -0,0 +1,182 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file EventLoop.hpp
+ * \brief Header file for the EventLoop class.
+ */
+
+#ifndef NCURSESCPP_EVENTLOOP_HPP_
+#define NCURSESCPP_EVENTLOOP_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <poll.h>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Event loop waiting on the terminal input, user file descriptors and timers.
+ * 
+ * The loop sleeps in poll until the terminal input or a user file descriptor is ready, a timer
+ * expires, wake() is called from another thread, or a frame of the frame scheduler is due.
+ * Keys read from the input window are dispatched to the key handler, mouse events to the mouse
+ * handler and KEY_RESIZE to the resize handler. A burst of resizes, such as the ones sent while a
+ * terminal corner is dragged, results in a single call of the resize handler once the terminal size
+ * settles. Pending frames of the frame scheduler are flushed after each iteration.
+ * 
+ * The loop works on the Screen owning its input window: it polls the input of that screen, flushes its
+ * frame scheduler and resizes it, and makes it current while it runs an iteration.
+ * 
+ * Input is read with Window::read_events, without blocking. As with Window::getch, reading from
+ * the input window refreshes it.
+ */
+class EventLoop
+{
+	public:
+	/// Clock used for the timers.
+	using Clock = std::chrono::steady_clock;
+	/// Identifier of a timer or file descriptor watch.
+	using Id = std::uint64_t;
+
+	using KeyHandler = std::function<void(int)>;                 ///< Called with the key code.
+	using MouseHandler = std::function<void(MEVENT const&)>;     ///< Called with the mouse event.
+	using ResizeHandler = std::function<void(int, int)>;         ///< Called with the new line and column counts.
+	using FdHandler = std::function<void(int, short)>;           ///< Called with the fd and the poll revents.
+	using TimerHandler = std::function<void()>;                  ///< Called when the timer expires.
+	using WakeHandler = std::function<void()>;                   ///< Called after wake().
+
+	EventLoop();
+	explicit EventLoop(Window&);
+
+	/// \cond NODOC
+	EventLoop(EventLoop const&) = delete;
+	EventLoop& operator=(EventLoop const&) = delete;
+
+	EventLoop(EventLoop&&) = delete;
+	EventLoop& operator=(EventLoop&&) = delete;
+	/// \endcond
+
+	~EventLoop();
+
+	void on_key(KeyHandler);
+	void on_mouse(MouseHandler);
+	void on_resize(ResizeHandler);
+	void on_wake(WakeHandler);
+	void set_resize_delay(Clock::duration);
+
+	Id add_fd(int, short, FdHandler);
+	void remove_fd(Id);
+
+	Id add_timer(Clock::duration, TimerHandler, Clock::duration = Clock::duration::zero());
+	void cancel_timer(Id);
+
+	int run();
+	int run_once(int = -1);
+	void stop();
+	void wake();
+
+	private:
+	/// \cond NODOC
+	struct Watch
+	{
+		Id id;
+		int fd;
+		short events;
+		FdHandler handler;
+	};
+
+	struct Timer
+	{
+		TimerHandler handler;
+		Clock::duration period;
+	};
+
+	struct Deadline
+	{
+		Clock::time_point when;
+		Id id;
+	};
+	/// \endcond
+
+	Window& input_;
+	Screen& screen_;
+	KeyHandler on_key_;
+	MouseHandler on_mouse_;
+	ResizeHandler on_resize_;
+	WakeHandler on_wake_;
+	std::vector<Watch> watches_;
+	std::vector<pollfd> pollfds_;
+	std::unordered_map<Id, Timer> timers_;
+	std::vector<Deadline> deadlines_;
+	Id next_id_;
+	int wake_pipe_[2];
+	bool stopped_;
+	Clock::duration resize_delay_;
+	Clock::time_point resize_deadline_;
+
+	static bool later_(Deadline const&, Deadline const&);
+	int wait_timeout_(int);
+	void prune_deadlines_();
+	void read_input_();
+	void run_timers_();
+	void run_resize_();
+	void drain_wake_pipe_();
+};
+
+} // namespace nccpp
+
+#ifndef NCCPP_EVENTLOOP_NOIMPL
+#include "Ncurses.hpp"
+
+#include "EventLoop.ipp"
+#endif
+
+#endif // Header guard
@@ -0,0 +1,411 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+#ifndef NCURSESCPP_EVENTLOOP_IPP_
+#define NCURSESCPP_EVENTLOOP_IPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "errors.hpp"
+
+namespace nccpp
+{
+
+/**
+ * \brief Create an event loop reading input from the standard screen of the Ncurses singleton.
+ * 
+ * \pre %Ncurses mode is on.
+ * \exception errors::EventLoopInit Thrown if the wake-up pipe can't be created.
+ */
+inline EventLoop::EventLoop()
+	: EventLoop{ncurses()}
+{}
+
+/**
+ * \brief Create an event loop reading input from a window.
+ * 
+ * The loop works on the screen owning the window.
+ * 
+ * \param input The window to read input from. It must outlive the loop.
+ * \pre The Window manages a ncurses window.
+ * \exception errors::EventLoopInit Thrown if the wake-up pipe can't be created.
+ */
+inline EventLoop::EventLoop(Window& input)
+	: input_{input}, screen_{input.get_owning_screen()}, on_key_{}, on_mouse_{}, on_resize_{}, on_wake_{}, watches_{}, pollfds_{},
+	  timers_{}, deadlines_{}, next_id_{1}, wake_pipe_{-1, -1}, stopped_{false},
+	  resize_delay_{std::chrono::milliseconds{50}}, resize_deadline_{Clock::time_point::max()}
+{
+	if (pipe(wake_pipe_) == -1 ||
+	    fcntl(wake_pipe_[0], F_SETFL, fcntl(wake_pipe_[0], F_GETFL) | O_NONBLOCK) == -1 ||
+	    fcntl(wake_pipe_[1], F_SETFL, fcntl(wake_pipe_[1], F_GETFL) | O_NONBLOCK) == -1)
+	{
+		if (wake_pipe_[0] != -1)
+		{
+			close(wake_pipe_[0]);
+			close(wake_pipe_[1]);
+		}
+		throw errors::EventLoopInit{};
+	}
+}
+
+inline EventLoop::~EventLoop()
+{
+	close(wake_pipe_[0]);
+	close(wake_pipe_[1]);
+}
+
+/**
+ * \brief Set the function called for each key read.
+ * 
+ * \param handler The handler, called with the key code.
+ */
+inline void EventLoop::on_key(KeyHandler handler)
+{
+	on_key_ = std::move(handler);
+}
+
+/**
+ * \brief Set the function called for each mouse event.
+ * 
+ * If no mouse handler is set, KEY_MOUSE is given to the key handler.
+ * 
+ * \param handler The handler, called with the event returned by getmouse.
+ */
+inline void EventLoop::on_mouse(MouseHandler handler)
+{
+	on_mouse_ = std::move(handler);
+}
+
+/**
+ * \brief Set the function called when the terminal is resized.
+ * 
+ * The handler is called once per burst of resizes, when no resize was received for the resize
+ * delay. Before calling it, the screen of the loop is resized to the size of its terminal with
+ * Screen::update_terminal_size(). The handler typically calls Layout::apply() and redraws.
+ * If no resize handler is set, KEY_RESIZE is given to the key handler.
+ * 
+ * \param handler The handler, called with the new number of lines and columns.
+ */
+inline void EventLoop::on_resize(ResizeHandler handler)
+{
+	on_resize_ = std::move(handler);
+}
+
+/**
+ * \brief Set the function called after wake() is called.
+ * 
+ * Several calls to wake() before the loop wakes up result in a single call of the handler.
+ * 
+ * \param handler The handler.
+ */
+inline void EventLoop::on_wake(WakeHandler handler)
+{
+	on_wake_ = std::move(handler);
+}
+
+/**
+ * \brief Set the time the terminal size must stay unchanged before the resize handler is called.
+ * 
+ * The default is 50 milliseconds. With a zero delay, the handler is called at the end of the
+ * iteration which read the resizes.
+ * 
+ * \param delay The delay.
+ */
+inline void EventLoop::set_resize_delay(Clock::duration delay)
+{
+	resize_delay_ = delay;
+}
+
+/**
+ * \brief Watch a file descriptor.
+ * 
+ * \param fd The file descriptor.
+ * \param events The poll events to wait for, such as POLLIN.
+ * \param handler The handler, called with the fd and the poll revents when the fd is ready.
+ * \return The identifier of the watch.
+ */
+inline EventLoop::Id EventLoop::add_fd(int fd, short events, FdHandler handler)
+{
+	auto id = next_id_++;
+	watches_.push_back(Watch{id, fd, events, std::move(handler)});
+	return id;
+}
+
+/**
+ * \brief Stop watching a file descriptor.
+ * 
+ * This function can be called from a handler, including the handler of the watch itself.
+ * 
+ * \param id The identifier returned by add_fd(). Nothing happens if the watch doesn't exist.
+ */
+inline void EventLoop::remove_fd(Id id)
+{
+	auto it = std::find_if(std::begin(watches_), std::end(watches_), [id](Watch const& w){ return w.id == id; });
+	if (it != std::end(watches_))
+		it->fd = -1;
+}
+
+/**
+ * \brief Start a timer.
+ * 
+ * \param delay Time before the timer expires.
+ * \param handler The handler, called when the timer expires.
+ * \param period If not zero, the timer is restarted with this period after expiring.
+ * \return The identifier of the timer.
+ */
+inline EventLoop::Id EventLoop::add_timer(Clock::duration delay, TimerHandler handler, Clock::duration period)
+{
+	auto id = next_id_++;
+	timers_.emplace(id, Timer{std::move(handler), period});
+	deadlines_.push_back(Deadline{Clock::now() + delay, id});
+	std::push_heap(std::begin(deadlines_), std::end(deadlines_), &EventLoop::later_);
+	return id;
+}
+
+/**
+ * \brief Cancel a timer.
+ * 
+ * This function can be called from a handler, including the handler of the timer itself.
+ * 
+ * \param id The identifier returned by add_timer(). Nothing happens if the timer doesn't exist.
+ */
+inline void EventLoop::cancel_timer(Id id)
+{
+	timers_.erase(id);
+	(this->prune_deadlines_)();
+}
+
+/**
+ * \brief Dispatch events until stop() is called.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return OK when stopped, or ERR if poll failed.
+ */
+inline int EventLoop::run()
+{
+	stopped_ = false;
+	while (!stopped_)
+		if ((this->run_once)() == ERR)
+			return ERR;
+	return OK;
+}
+
+/**
+ * \brief Wait for events once and dispatch them.
+ * 
+ * The wait is interrupted by the next timer or frame of the frame scheduler, and by signals.
+ * 
+ * \param timeout_ms Maximum time to wait in milliseconds, or -1 to wait without limit.
+ * \pre %Ncurses mode is on.
+ * \return OK, or ERR if poll failed.
+ */
+inline int EventLoop::run_once(int timeout_ms)
+{
+	internal::ScreenScope scope{screen_};
+	pollfds_.clear();
+	pollfds_.push_back(pollfd{screen_.get_input_fd(), POLLIN, 0});
+	pollfds_.push_back(pollfd{wake_pipe_[0], POLLIN, 0});
+	watches_.erase(std::remove_if(std::begin(watches_), std::end(watches_), [](Watch const& w){ return w.fd == -1; }),
+	               std::end(watches_));
+	for (auto const& w : watches_)
+		pollfds_.push_back(pollfd{w.fd, w.events, 0});
+
+	int ready{poll(pollfds_.data(), static_cast<nfds_t>(pollfds_.size()), (this->wait_timeout_)(timeout_ms))};
+	if (ready == -1 && errno != EINTR)
+		return ERR;
+
+	// A signal, such as SIGWINCH, may have queued a key even if the input fd isn't readable.
+	if (ready == -1 || pollfds_[0].revents)
+		(this->read_input_)();
+	if (ready > 0 && pollfds_[1].revents)
+		(this->drain_wake_pipe_)();
+	if (ready > 0)
+	{
+		// Handlers may add watches, only the ones polled are dispatched.
+		auto polled = pollfds_.size() - 2;
+		for (std::size_t i{0}; i != polled; ++i)
+		{
+			auto revents = pollfds_[i + 2].revents;
+			if (revents && watches_[i].fd != -1)
+			{
+				auto handler = watches_[i].handler;
+				handler(watches_[i].fd, revents);
+			}
+		}
+	}
+	(this->run_timers_)();
+	(this->run_resize_)();
+	return screen_.get_frame_scheduler().flush();
+}
+
+/**
+ * \brief Make run() return after the current iteration.
+ * 
+ * Must be called from the thread running the loop, such as from a handler. Use wake() from other threads.
+ */
+inline void EventLoop::stop()
+{
+	stopped_ = true;
+}
+
+/**
+ * \brief Wake the loop up and call the wake handler.
+ * 
+ * This function can be called from any thread, and from signal handlers.
+ */
+inline void EventLoop::wake()
+{
+	char byte{0};
+	while (write(wake_pipe_[1], &byte, 1) == -1 && errno == EINTR)
+		;
+}
+
+/// \cond NODOC
+inline bool EventLoop::later_(Deadline const& lhs, Deadline const& rhs)
+{
+	return lhs.when > rhs.when;
+}
+
+inline int EventLoop::wait_timeout_(int timeout_ms)
+{
+	(this->prune_deadlines_)();
+	auto deadline = resize_deadline_;
+	if (!deadlines_.empty())
+		deadline = std::min(deadline, deadlines_.front().when);
+	auto const& scheduler = screen_.get_frame_scheduler();
+	if (scheduler.pending())
+		deadline = std::min(deadline, scheduler.next_frame_time());
+	if (deadline == Clock::time_point::max())
+		return timeout_ms;
+
+	auto now = Clock::now();
+	if (deadline <= now)
+		return 0;
+	// Round up, so that the timer has expired when poll returns.
+	auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now + std::chrono::milliseconds{1} -
+	                                                                  Clock::duration{1});
+	auto ms = static_cast<int>(std::min<std::chrono::milliseconds::rep>(wait.count(), 1 << 30));
+	return timeout_ms < 0 ? ms : std::min(ms, timeout_ms);
+}
+
+// Cancelled timers are left in the heap, drop the ones which would wake the loop up next
+inline void EventLoop::prune_deadlines_()
+{
+	while (!deadlines_.empty() && timers_.find(deadlines_.front().id) == std::end(timers_))
+	{
+		std::pop_heap(std::begin(deadlines_), std::end(deadlines_), &EventLoop::later_);
+		deadlines_.pop_back();
+	}
+}
+
+inline void EventLoop::read_input_()
+{
+	// ncurses buffers input, so read until it has nothing left instead of polling again.
+	Event events[64];
+	std::size_t n{0};
+	do
+	{
+		n = input_.read_events(events);
+		for (std::size_t i{0}; i != n; ++i)
+		{
+			auto const& event = events[i];
+			if (event.type == Event::Type::mouse && on_mouse_)
+				on_mouse_(event.mouse);
+			else if (event.type == Event::Type::resize && on_resize_)
+				resize_deadline_ = Clock::now() + resize_delay_;
+			else if (on_key_)
+				on_key_(event.key);
+		}
+	} while (n == sizeof(events) / sizeof(events[0]));
+}
+
+inline void EventLoop::run_timers_()
+{
+	auto now = Clock::now();
+	while (!deadlines_.empty() && deadlines_.front().when <= now)
+	{
+		std::pop_heap(std::begin(deadlines_), std::end(deadlines_), &EventLoop::later_);
+		auto expired = deadlines_.back();
+		deadlines_.pop_back();
+		auto it = timers_.find(expired.id);
+		if (it == std::end(timers_))
+			continue;
+		// Copy the handler, it may cancel its own timer.
+		auto handler = it->second.handler;
+		if (it->second.period != Clock::duration::zero())
+		{
+			// Keep the period without drift, but skip the expirations already missed.
+			auto next = expired.when + it->second.period;
+			if (next <= now)
+				next = now + it->second.period;
+			deadlines_.push_back(Deadline{next, expired.id});
+			std::push_heap(std::begin(deadlines_), std::end(deadlines_), &EventLoop::later_);
+		}
+		else
+			timers_.erase(it);
+		handler();
+	}
+}
+
+inline void EventLoop::run_resize_()
+{
+	if (resize_deadline_ == Clock::time_point::max() || resize_deadline_ > Clock::now())
+		return;
+	resize_deadline_ = Clock::time_point::max();
+	screen_.update_terminal_size();
+	if (on_resize_)
+		on_resize_(screen_.line_count(), screen_.column_count());
+}
+
+inline void EventLoop::drain_wake_pipe_()
+{
+	char buffer[64];
+	while (read(wake_pipe_[0], buffer, sizeof(buffer)) > 0)
+		;
+	if (on_wake_)
+		on_wake_();
+}
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
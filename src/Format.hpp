@@ -0,0 +1,519 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+/**
+ * \file Format.hpp
+ * \brief Header file for the type-safe formatting used by Window::printw.
+ */
+
+#ifndef NCURSESCPP_FORMAT_HPP_
+#define NCURSESCPP_FORMAT_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+/**
+ * \brief Size of the stack buffer used by Window::printw, including the terminating null character.
+ * 
+ * Longer outputs are truncated.
+ */
+#ifndef NCCPP_PRINTW_BUFFER_SIZE
+#define NCCPP_PRINTW_BUFFER_SIZE 512
+#endif
+
+/// \cond NODOC
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#define NCCPP_CONSTEVAL consteval
+#define NCCPP_HAS_CONSTEVAL
+#else
+#define NCCPP_CONSTEVAL constexpr
+#endif
+/// \endcond
+
+namespace nccpp
+{
+
+/// \cond NODOC
+namespace internal
+{
+
+template <typename T>
+struct Identity
+{
+	using type = T;
+};
+
+enum class FormatArg
+{
+	integer,
+	floating,
+	string,
+	other
+};
+
+template <typename T>
+struct IsFormatString
+	: std::integral_constant<bool, std::is_same<T, char const*>::value || std::is_same<T, char*>::value ||
+	                               std::is_same<T, std::string>::value>
+{};
+
+template <typename T>
+constexpr FormatArg format_arg_kind()
+{
+	return std::is_integral<T>::value ? FormatArg::integer
+	     : std::is_floating_point<T>::value ? FormatArg::floating
+	     : IsFormatString<T>::value ? FormatArg::string
+	     : FormatArg::other;
+}
+
+template <typename... Args>
+struct FormatArgs
+{
+	static FormatArg constexpr kinds[sizeof...(Args) + 1]{
+		format_arg_kind<typename std::decay<Args>::type>()..., FormatArg::other};
+};
+
+template <typename... Args>
+FormatArg constexpr FormatArgs<Args...>::kinds[sizeof...(Args) + 1];
+
+constexpr bool all_formattable(FormatArg const* kinds, std::size_t n)
+{
+	return n == 0 || (*kinds != FormatArg::other && all_formattable(kinds + 1, n - 1));
+}
+
+constexpr bool all_integers(FormatArg const* kinds, std::size_t n)
+{
+	return n == 0 || (*kinds == FormatArg::integer && all_integers(kinds + 1, n - 1));
+}
+
+template <typename... Args>
+struct IsFormattable
+	: std::integral_constant<bool, all_formattable(FormatArgs<Args...>::kinds, sizeof...(Args))>
+{};
+
+constexpr char const* skip_format_flags(char const* s)
+{
+	return (*s == '-' || *s == '+' || *s == ' ' || *s == '0' || *s == '#') ? skip_format_flags(s + 1) : s;
+}
+
+constexpr char const* skip_format_digits(char const* s)
+{
+	return (*s >= '0' && *s <= '9') ? skip_format_digits(s + 1) : s;
+}
+
+// A '*' width or precision is read from an int argument
+constexpr char const* skip_format_width(char const* s)
+{
+	return *s == '*' ? s + 1 : skip_format_digits(s);
+}
+
+constexpr char const* skip_format_precision(char const* s)
+{
+	return *s == '.' ? skip_format_width(s + 1) : s;
+}
+
+constexpr char const* skip_format_length(char const* s)
+{
+	return (*s == 'h' || *s == 'l' || *s == 'L' || *s == 'z' || *s == 'j' || *s == 't') ?
+	       skip_format_length(s + 1) : s;
+}
+
+// Get the conversion character of the specification following a '%'
+constexpr char const* format_conversion(char const* s)
+{
+	return skip_format_length(skip_format_precision(skip_format_width(skip_format_flags(s))));
+}
+
+// Get the number of '*' in the specification from s to its conversion character
+constexpr std::size_t format_stars(char const* s, char const* conv)
+{
+	return s == conv ? 0 : (*s == '*' ? 1 : 0) + format_stars(s + 1, conv);
+}
+
+constexpr bool format_accepts(char conv, FormatArg kind)
+{
+	return (conv == 'd' || conv == 'i' || conv == 'u' || conv == 'o' || conv == 'x' || conv == 'X' ||
+	        conv == 'c') ? kind == FormatArg::integer
+	     : (conv == 'f' || conv == 'F' || conv == 'e' || conv == 'E' || conv == 'g' || conv == 'G' ||
+	        conv == 'a' || conv == 'A') ? kind == FormatArg::floating
+	     : conv == 's' ? kind == FormatArg::string
+	     : false;
+}
+
+constexpr bool check_format(char const*, FormatArg const*, std::size_t);
+
+constexpr bool check_format_spec(char const* conv, std::size_t stars, FormatArg const* kinds, std::size_t n)
+{
+	return n > stars && all_integers(kinds, stars) && format_accepts(*conv, kinds[stars]) &&
+	       check_format(conv + 1, kinds + stars + 1, n - stars - 1);
+}
+
+constexpr bool check_format(char const* s, FormatArg const* kinds, std::size_t n)
+{
+	return *s == '\0' ? n == 0
+	     : *s != '%' ? check_format(s + 1, kinds, n)
+	     : s[1] == '%' ? check_format(s + 2, kinds, n)
+	     : check_format_spec(format_conversion(s + 1), format_stars(s + 1, format_conversion(s + 1)), kinds, n);
+}
+
+// Not constexpr : reaching it during constant evaluation makes the program ill-formed
+inline void invalid_format_string_for_arguments()
+{
+	assert(false && "Format string doesn't match the arguments");
+}
+
+// Format string of the C varargs printw. Converting to it is as costly as converting to a FormatString,
+// so that the checked overload wins whenever it's viable.
+struct VarargsFormat
+{
+	VarargsFormat(char const* s) : str{s} {}
+
+	char const* str;
+};
+
+} // namespace internal
+/// \endcond
+
+/**
+ * \brief Format string whose content isn't known at compile time.
+ * 
+ * \see runtime_format()
+ */
+struct RuntimeFormat
+{
+	char const* str; ///< The format string.
+};
+
+/**
+ * \brief Wrap a format string that isn't a literal.
+ * 
+ * \param str The format string.
+ * \return The wrapped string, which can be passed on to Window::printw.
+ */
+inline RuntimeFormat runtime_format(char const* str)
+{
+	return RuntimeFormat{str};
+}
+
+/**
+ * \brief Format string checked against the types of the arguments.
+ * 
+ * Supported conversions are `d i u o x X c` for integers, `f F e E g G a A` for floating-point numbers
+ * and `s` for strings (`char const*` and `std::string`), with optional flags, width and precision.
+ * A `*` width or precision is read from an integer argument, as with printf.
+ * Length modifiers are accepted and ignored, as the argument types are known.
+ * 
+ * When constructed from a literal, the string is checked at compile time if the compiler supports
+ * `consteval` (C++20). Otherwise, and for the strings known at runtime, the check is only done when
+ * NDEBUG isn't defined, so that it doesn't slow down printw in release builds.
+ * 
+ * Conversions outside of this list are rejected. Calls passing arguments of other types, such as the pointers
+ * of `%p` and `%n`, use the C varargs overload of Window::printw instead, which isn't checked.
+ * 
+ * \tparam Args Types of the arguments.
+ */
+template <typename... Args>
+class FormatString
+{
+	static_assert(internal::all_formattable(internal::FormatArgs<Args...>::kinds, sizeof...(Args)),
+	              "Format arguments must be integers, floating-point numbers or strings");
+
+	public:
+	/// \cond NODOC
+	template <std::size_t N>
+	NCCPP_CONSTEVAL FormatString(char const (&str)[N])
+#if defined(NCCPP_HAS_CONSTEVAL) || !defined(NDEBUG)
+		: str_{internal::check_format(str, internal::FormatArgs<Args...>::kinds, sizeof...(Args)) ?
+		       str : (internal::invalid_format_string_for_arguments(), str)}
+#else
+		: str_{str}
+#endif
+	{}
+
+	template <typename T, typename = typename std::enable_if<std::is_same<T, char const*>::value ||
+	                                                         std::is_same<T, char*>::value>::type>
+	FormatString(T str)
+		: FormatString{RuntimeFormat{str}}
+	{}
+
+	FormatString(RuntimeFormat fmt)
+		: str_{fmt.str}
+	{
+#ifndef NDEBUG
+		if (!internal::check_format(str_, internal::FormatArgs<Args...>::kinds, sizeof...(Args)))
+			internal::invalid_format_string_for_arguments();
+#endif
+	}
+	/// \endcond
+
+	/**
+	 * \brief Get the format string.
+	 * 
+	 * \return The format string.
+	 */
+	constexpr char const* get() const
+	{
+		return str_;
+	}
+
+	private:
+	char const* str_;
+};
+
+/// \cond NODOC
+namespace internal
+{
+
+// Values of the '*' width and precision of a specification
+struct FormatStars
+{
+	int values[2];
+	std::size_t count;
+};
+
+template <typename T>
+int format_star(T const& value, std::true_type)
+{
+	return static_cast<int>(value);
+}
+
+template <typename T>
+int format_star(T const&, std::false_type)
+{
+	return 0;
+}
+
+template <std::size_t N>
+class FormatBuffer
+{
+	public:
+	FormatBuffer() : size_{0} {}
+
+	FormatBuffer(FormatBuffer const&) = delete;
+	FormatBuffer& operator=(FormatBuffer const&) = delete;
+
+	char const* data() const
+	{
+		return data_;
+	}
+
+	std::size_t size() const
+	{
+		return size_;
+	}
+
+	void append(char const* str, std::size_t n)
+	{
+		n = n < N - 1 - size_ ? n : N - 1 - size_;
+		std::memcpy(data_ + size_, str, n);
+		size_ += n;
+	}
+
+	template <typename T>
+	void append_printf(char const* spec, FormatStars const& stars, T value)
+	{
+		auto n = stars.count == 0 ? std::snprintf(data_ + size_, N - size_, spec, value)
+		       : stars.count == 1 ? std::snprintf(data_ + size_, N - size_, spec, stars.values[0], value)
+		       : std::snprintf(data_ + size_, N - size_, spec, stars.values[0], stars.values[1], value);
+		if (n > 0)
+			size_ += static_cast<std::size_t>(n) < N - 1 - size_ ? static_cast<std::size_t>(n) : N - 1 - size_;
+	}
+
+	private:
+	char data_[N];
+	std::size_t size_;
+};
+
+// Build a printf specification from a checked one, replacing the length modifier and the conversion
+class FormatSpec
+{
+	public:
+	FormatSpec(char const* spec, char const* conv, char const* length, char new_conv)
+		: size_{0}
+	{
+		auto end = skip_format_precision(skip_format_width(skip_format_flags(spec + 1)));
+		for (; spec != end && size_ < sizeof data_ - 4; ++spec)
+			data_[size_++] = *spec;
+		for (; *length; ++length)
+			data_[size_++] = *length;
+		data_[size_++] = accepts_(conv, new_conv) ? *conv : new_conv;
+		data_[size_] = '\0';
+	}
+
+	char const* get() const
+	{
+		return data_;
+	}
+
+	private:
+	char data_[32];
+	std::size_t size_;
+
+	static bool accepts_(char const* conv, char new_conv)
+	{
+		return new_conv == 'd' ? format_accepts(*conv, FormatArg::integer) && *conv != 'c'
+		     : new_conv == 'g' ? format_accepts(*conv, FormatArg::floating)
+		     : *conv == new_conv;
+	}
+};
+
+// Unsigned type printf reads an unsigned conversion of a T argument as, after the integral promotions
+template <typename T>
+struct FormatUnsigned : std::make_unsigned<decltype(+T{})>
+{};
+
+template <std::size_t N>
+char const* format_literal(FormatBuffer<N>& buf, char const* fmt)
+{
+	for (;;)
+	{
+		auto start = fmt;
+		while (*fmt && *fmt != '%')
+			++fmt;
+		buf.append(start, static_cast<std::size_t>(fmt - start));
+		if (fmt[0] != '%' || fmt[1] != '%')
+			return fmt;
+		buf.append(fmt, 1);
+		fmt += 2;
+	}
+}
+
+template <std::size_t N, typename T>
+void format_value(FormatBuffer<N>& buf, char const* spec, char const* conv, FormatStars const& stars,
+                  T value, std::integral_constant<FormatArg, FormatArg::integer>)
+{
+	if (conv == spec + 1 && (*conv == 'd' || *conv == 'i' || *conv == 'u'))
+	{
+		char digits[24];
+		auto pos = sizeof digits;
+		auto negative = value < T{0} && *conv != 'u';
+		auto n = negative ? 0ull - static_cast<unsigned long long>(value)
+		                  : static_cast<unsigned long long>(static_cast<typename FormatUnsigned<T>::type>(value));
+		do
+			digits[--pos] = static_cast<char>('0' + n % 10);
+		while (n /= 10);
+		if (negative)
+			digits[--pos] = '-';
+		buf.append(digits + pos, sizeof digits - pos);
+	}
+	else if (*conv == 'c')
+		buf.append_printf(FormatSpec{spec, conv, "", 'c'}.get(), stars, static_cast<int>(value));
+	else if (*conv == 'd' || *conv == 'i' || !format_accepts(*conv, FormatArg::integer))
+		buf.append_printf(FormatSpec{spec, conv, "ll", 'd'}.get(), stars, static_cast<long long>(value));
+	else
+	{
+		auto u = static_cast<typename FormatUnsigned<T>::type>(value);
+		buf.append_printf(FormatSpec{spec, conv, "ll", 'd'}.get(), stars, static_cast<unsigned long long>(u));
+	}
+}
+
+template <std::size_t N, typename T>
+void format_value(FormatBuffer<N>& buf, char const* spec, char const* conv, FormatStars const& stars,
+                  T value, std::integral_constant<FormatArg, FormatArg::floating>)
+{
+	if (std::is_same<T, long double>::value)
+		buf.append_printf(FormatSpec{spec, conv, "L", 'g'}.get(), stars, static_cast<long double>(value));
+	else
+		buf.append_printf(FormatSpec{spec, conv, "", 'g'}.get(), stars, static_cast<double>(value));
+}
+
+template <std::size_t N>
+void format_value(FormatBuffer<N>& buf, char const* spec, char const* conv, FormatStars const& stars,
+                  char const* value, std::integral_constant<FormatArg, FormatArg::string>)
+{
+	if (conv == spec + 1)
+		buf.append(value, std::strlen(value));
+	else
+		buf.append_printf(FormatSpec{spec, conv, "", 's'}.get(), stars, value);
+}
+
+template <std::size_t N>
+void format_value(FormatBuffer<N>& buf, char const* spec, char const* conv, FormatStars const& stars,
+                  std::string const& value, std::integral_constant<FormatArg, FormatArg::string> kind)
+{
+	if (conv == spec + 1)
+		buf.append(value.data(), value.size());
+	else
+		format_value(buf, spec, conv, stars, value.c_str(), kind);
+}
+
+template <std::size_t N>
+void format_args(FormatBuffer<N>& buf, char const* fmt)
+{
+	format_literal(buf, fmt);
+}
+
+template <std::size_t N, typename T, typename... Rest>
+void format_args(FormatBuffer<N>&, char const*, T const&, Rest const&...);
+
+// Only reached with a format that doesn't match the arguments
+template <std::size_t N>
+void format_spec(FormatBuffer<N>&, char const*, FormatStars)
+{}
+
+// Read the '*' width and precision of the specification, then format its value
+template <std::size_t N, typename T, typename... Rest>
+void format_spec(FormatBuffer<N>& buf, char const* spec, FormatStars stars, T const& arg, Rest const&... rest)
+{
+	auto conv = format_conversion(spec + 1);
+	if (stars.count != format_stars(spec + 1, conv))
+	{
+		stars.values[stars.count++] = format_star(arg, std::is_integral<T>{});
+		format_spec(buf, spec, stars, rest...);
+		return;
+	}
+	using Kind = std::integral_constant<FormatArg, format_arg_kind<typename std::decay<T>::type>()>;
+	format_value(buf, spec, conv, stars, arg, Kind{});
+	format_args(buf, *conv ? conv + 1 : conv, rest...);
+}
+
+template <std::size_t N, typename T, typename... Rest>
+void format_args(FormatBuffer<N>& buf, char const* fmt, T const& arg, Rest const&... rest)
+{
+	fmt = format_literal(buf, fmt);
+	if (*fmt)
+		format_spec(buf, fmt, FormatStars{{0, 0}, 0}, arg, rest...);
+}
+
+} // namespace internal
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -0,0 +1,143 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file FrameScheduler.hpp
+ * \brief Header file for the FrameScheduler class.
+ */
+
+#ifndef NCURSESCPP_FRAMESCHEDULER_HPP_
+#define NCURSESCPP_FRAMESCHEDULER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Counters describing the behaviour of the frame scheduler.
+ */
+struct FrameStats
+{
+	std::size_t requests; ///< Refreshes requested through schedule().
+	std::size_t frames;   ///< Physical screen updates, i.e. doupdate calls.
+	std::size_t windows;  ///< Windows copied to the virtual screen by those frames.
+};
+
+/**
+ * \brief Coalesce the refreshes of several windows into a single screen update.
+ * 
+ * Each Screen owns a scheduler, accessed with Screen::get_frame_scheduler(). Flushing it updates that
+ * screen, even if another one is current.
+ * Windows scheduled for refresh are copied to the virtual screen with wnoutrefresh, in increasing
+ * z order, and the physical screen is then updated by a single doupdate call. The frame rate can
+ * be capped, in which case flush() does nothing until the next frame is due.
+ * 
+ * Once coalescing is enabled with set_coalescing(), Window::refresh() schedules the window instead
+ * of updating the screen, and the application has to call flush() from its main loop.
+ */
+class FrameScheduler
+{
+	public:
+	/// Clock used to pace frames.
+	using Clock = std::chrono::steady_clock;
+
+	explicit FrameScheduler(Screen&);
+
+	/// \cond NODOC
+	FrameScheduler(FrameScheduler const&) = delete;
+	FrameScheduler& operator=(FrameScheduler const&) = delete;
+
+	FrameScheduler(FrameScheduler&&) = delete;
+	FrameScheduler& operator=(FrameScheduler&&) = delete;
+	/// \endcond
+
+	~FrameScheduler() = default;
+
+	void schedule(Window&);
+	void schedule(Window&, int);
+	void cancel(Window&);
+	bool pending() const;
+
+	int flush();
+	int flush_now();
+
+	void set_max_frame_rate(double);
+	double get_max_frame_rate() const;
+	Clock::time_point next_frame_time() const;
+
+	void set_coalescing(bool);
+	bool is_coalescing() const;
+
+	FrameStats frame_stats() const;
+	void reset_frame_stats();
+
+	private:
+	/// \cond NODOC
+	struct Entry
+	{
+		WINDOW* win;
+		int z;
+	};
+	/// \endcond
+
+	Screen* screen_;
+	std::vector<Entry> entries_;
+	Clock::duration min_interval_;
+	Clock::time_point last_frame_;
+	bool coalescing_;
+	FrameStats stats_;
+};
+
+} // namespace nccpp
+
+#ifndef NCCPP_FRAMESCHEDULER_NOIMPL
+#include "Ncurses.hpp"
+
+#include "FrameScheduler.ipp"
+#endif
+
+#endif // Header guard
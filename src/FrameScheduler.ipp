@@ -0,0 +1,244 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+#ifndef NCURSESCPP_FRAMESCHEDULER_IPP_
+#define NCURSESCPP_FRAMESCHEDULER_IPP_
+
+#include <algorithm>
+#include <cassert>
+
+namespace nccpp
+{
+
+/**
+ * \brief Create a scheduler without frame rate limit, with coalescing disabled.
+ * 
+ * \param screen The screen whose windows are scheduled.
+ */
+inline FrameScheduler::FrameScheduler(Screen& screen)
+	: screen_{&screen}, entries_{}, min_interval_{Clock::duration::zero()}, last_frame_{}, coalescing_{false},
+	  stats_{0, 0, 0}
+{}
+
+/**
+ * \brief Schedule a window for the next frame.
+ * 
+ * A window which isn't scheduled yet gets the z order 0. Scheduling an already scheduled window
+ * keeps its z order, so that Window::refresh() doesn't move a window given an explicit z.
+ * 
+ * \param win The window to refresh.
+ * \pre The Window manages a ncurses window, which isn't a pad.
+ */
+inline void FrameScheduler::schedule(Window& win)
+{
+	WINDOW* handle{win.get_handle()};
+	assert(!is_pad(handle) && "Pads can't be scheduled");
+	++stats_.requests;
+	auto it = std::find_if(std::begin(entries_), std::end(entries_),
+	                       [handle](Entry const& e){ return e.win == handle; });
+	if (it == std::end(entries_))
+		entries_.push_back(Entry{handle, 0});
+}
+
+/**
+ * \brief Schedule a window for the next frame, with a given z order.
+ * 
+ * Scheduling an already scheduled window only updates its z order.
+ * 
+ * \param win The window to refresh.
+ * \param z Stacking order of the window, windows with a higher z are drawn over lower ones.
+ * Windows with the same z are drawn in the order they were first scheduled.
+ * \pre The Window manages a ncurses window, which isn't a pad.
+ */
+inline void FrameScheduler::schedule(Window& win, int z)
+{
+	WINDOW* handle{win.get_handle()};
+	assert(!is_pad(handle) && "Pads can't be scheduled");
+	++stats_.requests;
+	auto it = std::find_if(std::begin(entries_), std::end(entries_),
+	                       [handle](Entry const& e){ return e.win == handle; });
+	if (it != std::end(entries_))
+		it->z = z;
+	else
+		entries_.push_back(Entry{handle, z});
+}
+
+/**
+ * \brief Remove a window from the next frame.
+ * 
+ * Windows are automatically cancelled when destroyed.
+ * 
+ * \param win The window to remove. Nothing happens if it isn't scheduled.
+ */
+inline void FrameScheduler::cancel(Window& win)
+{
+	WINDOW* handle{win.get_handle()};
+	entries_.erase(std::remove_if(std::begin(entries_), std::end(entries_),
+	                              [handle](Entry const& e){ return e.win == handle; }),
+	               std::end(entries_));
+}
+
+/**
+ * \brief Check if some windows are waiting for the next frame.
+ * 
+ * \return true if at least one window is scheduled.
+ */
+inline bool FrameScheduler::pending() const
+{
+	return !entries_.empty();
+}
+
+/**
+ * \brief Draw the next frame if it is due.
+ * 
+ * Nothing is done if no window is scheduled, or if the frame rate limit doesn't allow a new frame
+ * yet. In the latter case the windows stay scheduled.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int FrameScheduler::flush()
+{
+	if (entries_.empty() || Clock::now() < (this->next_frame_time)())
+		return OK;
+	return (this->flush_now)();
+}
+
+/**
+ * \brief Draw the scheduled windows now, ignoring the frame rate limit.
+ * 
+ * Each scheduled window is copied to the virtual screen with wnoutrefresh in increasing z order,
+ * then the physical screen is updated with a single doupdate call.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int FrameScheduler::flush_now()
+{
+	if (entries_.empty())
+		return OK;
+	internal::ScreenScope scope{*screen_};
+	std::stable_sort(std::begin(entries_), std::end(entries_),
+	                 [](Entry const& lhs, Entry const& rhs){ return lhs.z < rhs.z; });
+	int ret{OK};
+	for (auto const& e : entries_)
+		if (wnoutrefresh(e.win) == ERR)
+			ret = ERR;
+	stats_.windows += entries_.size();
+	++stats_.frames;
+	entries_.clear();
+	last_frame_ = Clock::now();
+	return screen_->doupdate() == ERR ? ERR : ret;
+}
+
+/**
+ * \brief Cap the frame rate.
+ * 
+ * \param fps Maximum number of frames per second. 0 removes the limit.
+ */
+inline void FrameScheduler::set_max_frame_rate(double fps)
+{
+	if (fps > 0.)
+		min_interval_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>{1. / fps});
+	else
+		min_interval_ = Clock::duration::zero();
+}
+
+/**
+ * \brief Get the frame rate limit.
+ * 
+ * \return Maximum number of frames per second, or 0 if there is no limit.
+ */
+inline double FrameScheduler::get_max_frame_rate() const
+{
+	if (min_interval_ == Clock::duration::zero())
+		return 0.;
+	return 1. / std::chrono::duration_cast<std::chrono::duration<double>>(min_interval_).count();
+}
+
+/**
+ * \brief Get the earliest time at which flush() will draw a frame.
+ * 
+ * \return The time of the last frame plus the minimum interval between frames.
+ */
+inline FrameScheduler::Clock::time_point FrameScheduler::next_frame_time() const
+{
+	return last_frame_ + min_interval_;
+}
+
+/**
+ * \brief Enable or disable refresh coalescing.
+ * 
+ * When enabled, Window::refresh() schedules the window with a z of 0 instead of updating the screen.
+ * 
+ * \param enable true to enable coalescing.
+ */
+inline void FrameScheduler::set_coalescing(bool enable)
+{
+	coalescing_ = enable;
+}
+
+/**
+ * \brief Check if refresh coalescing is enabled.
+ * 
+ * \return true if Window::refresh() schedules windows.
+ */
+inline bool FrameScheduler::is_coalescing() const
+{
+	return coalescing_;
+}
+
+/**
+ * \brief Get the scheduler counters.
+ * 
+ * \return The counters accumulated since the creation of the scheduler or the last reset.
+ */
+inline FrameStats FrameScheduler::frame_stats() const
+{
+	return stats_;
+}
+
+/**
+ * \brief Reset the scheduler counters.
+ */
+inline void FrameScheduler::reset_frame_stats()
+{
+	stats_ = FrameStats{0, 0, 0};
+}
+
+} // namespace nccpp
+
+#endif // Header guard
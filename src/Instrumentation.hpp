@@ -0,0 +1,174 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file Instrumentation.hpp
+ * \brief Header file for the rendering counters enabled by NCCPP_INSTRUMENTATION.
+ * 
+ * Define NCCPP_INSTRUMENTATION in every translation unit including ncursescpp to count, per window,
+ * the output function calls, the cells written, the refreshes and the time they take. Without it,
+ * the counters are compiled out.
+ */
+
+#ifndef NCURSESCPP_INSTRUMENTATION_HPP_
+#define NCURSESCPP_INSTRUMENTATION_HPP_
+
+#ifdef NCCPP_INSTRUMENTATION
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace nccpp
+{
+
+class Window;
+
+/**
+ * \brief Groups of output functions counted by the instrumentation layer.
+ * 
+ * The mv* variants are counted with the function they delegate to.
+ */
+enum class OutputFunction
+{
+	addch,    ///< addch, echochar.
+	printw,   ///< printw.
+	addstr,   ///< addstr, addnstr, and the lines written by TailView.
+	addchstr, ///< addchstr, addchnstr, and the spans written by Canvas.
+	insch,    ///< insch.
+	insstr,   ///< insstr, insnstr.
+	blit,     ///< Both blit overloads, and the rows and runs written by load.
+	add_utf8, ///< add_utf8.
+	add_runs, ///< add_runs.
+	lines,    ///< border, box, hline, vline.
+	chgat,    ///< chgat.
+	count     ///< Number of groups, not a function.
+};
+
+/**
+ * \brief Rendering counters of a window.
+ * 
+ * Only calls made through the member functions of the library's classes are counted.
+ */
+struct WindowRenderStats
+{
+	Window const* window; ///< The window, or the Screen object for stdscr. Set by Screen::render_stats.
+	std::size_t calls[static_cast<std::size_t>(OutputFunction::count)]; ///< Calls, indexed by OutputFunction.
+	std::size_t cells_written;           ///< Cells passed to the output functions, before clipping.
+	std::size_t refreshes;               ///< Calls to wrefresh or prefresh.
+	std::size_t outrefreshes;            ///< Calls to wnoutrefresh or pnoutrefresh.
+	std::size_t touched_lines;           ///< Lines passed to touchln.
+	std::chrono::nanoseconds refresh_time; ///< Time spent in wrefresh and prefresh.
+	std::size_t memory; ///< Bytes of cells held by the window, 0 for subwindows. Set by Screen::render_stats.
+};
+
+/**
+ * \brief Snapshot of the rendering counters, returned by Screen::render_stats.
+ */
+struct RenderStats
+{
+	std::vector<WindowRenderStats> windows; ///< stdscr, then every live window in creation order.
+	std::size_t doupdates;                  ///< Calls to Screen::doupdate, frame scheduler flushes included.
+	std::chrono::nanoseconds doupdate_time; ///< Time spent in doupdate.
+	std::size_t memory;                     ///< Sum of the memory of the windows.
+};
+
+/// \cond NODOC
+namespace internal
+{
+
+// Add the lifetime of the object to a duration
+class ScopedTimer
+{
+	public:
+	explicit ScopedTimer(std::chrono::nanoseconds& total)
+		: total_(total), start_{std::chrono::steady_clock::now()}
+	{}
+
+	ScopedTimer(ScopedTimer const&) = delete;
+	ScopedTimer& operator=(ScopedTimer const&) = delete;
+
+	~ScopedTimer()
+	{
+		total_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+	}
+
+	private:
+	std::chrono::nanoseconds& total_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+template <typename Char>
+std::size_t chstr_length(Char const* chstr)
+{
+	std::size_t n{0};
+	while (chstr[n])
+		++n;
+	return n;
+}
+
+// Counters of a window, for the classes drawing into it. Defined in Window.ipp.
+inline WindowRenderStats& render_stats_of(Window&);
+
+inline void record_output(WindowRenderStats& stats, OutputFunction fn, std::size_t cells)
+{
+	++stats.calls[static_cast<std::size_t>(fn)];
+	stats.cells_written += cells;
+}
+
+} // namespace internal
+/// \endcond
+
+} // namespace nccpp
+
+/// \cond NODOC
+#define NCCPP_RECORD_OUTPUT(win, fn, cells) \
+	::nccpp::internal::record_output(::nccpp::internal::render_stats_of(win), ::nccpp::OutputFunction::fn, (cells))
+#define NCCPP_RECORD(win, counter, n) (::nccpp::internal::render_stats_of(win).counter += (n))
+#define NCCPP_TIME_SCOPE(total) ::nccpp::internal::ScopedTimer nccpp_timer_{total}
+/// \endcond
+
+#else
+
+/// \cond NODOC
+#define NCCPP_RECORD_OUTPUT(win, fn, cells) ((void)0)
+#define NCCPP_RECORD(win, counter, n) ((void)0)
+#define NCCPP_TIME_SCOPE(total) ((void)0)
+/// \endcond
+
+#endif // NCCPP_INSTRUMENTATION
+
+#endif // Header guard
@@ -0,0 +1,248 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file Layout.hpp
+ * \brief Header file for the Layout class.
+ */
+
+#ifndef NCURSESCPP_LAYOUT_HPP_
+#define NCURSESCPP_LAYOUT_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+#ifndef NCCPP_SUBWINDOW_NOIMPL
+#define NCCPP_SUBWINDOW_NOIMPL
+#include "Subwindow.hpp"
+#undef NCCPP_SUBWINDOW_NOIMPL
+#else
+#include "Subwindow.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Size of a layout node along the direction of its parent.
+ * 
+ * Across that direction, a node always takes the whole size of its parent.
+ */
+struct Constraint
+{
+	/**
+	 * \brief Type of a constraint.
+	 */
+	enum class Type
+	{
+		fixed,      ///< *value* lines or columns.
+		percentage, ///< *value* percent of the parent, rounded down.
+		fill        ///< A share of the space left by the other children, weighted by *value*.
+	};
+
+	Type type; ///< Type of the constraint.
+	int value; ///< Size, percentage or weight, depending on the type.
+
+	/**
+	 * \brief Create a fixed size constraint.
+	 * 
+	 * \param n Number of lines or columns.
+	 * \return The constraint.
+	 */
+	static constexpr Constraint fixed(int n)
+	{
+		return Constraint{Type::fixed, n};
+	}
+
+	/**
+	 * \brief Create a percentage constraint.
+	 * 
+	 * \param p Percentage of the parent.
+	 * \return The constraint.
+	 */
+	static constexpr Constraint percentage(int p)
+	{
+		return Constraint{Type::percentage, p};
+	}
+
+	/**
+	 * \brief Create a fill constraint.
+	 * 
+	 * \param weight Weight of the node in the space left.
+	 * \return The constraint.
+	 */
+	static constexpr Constraint fill(int weight = 1)
+	{
+		return Constraint{Type::fill, weight};
+	}
+};
+
+inline bool operator==(Constraint const& lhs, Constraint const& rhs)
+{
+	return lhs.type == rhs.type && lhs.value == rhs.value;
+}
+
+inline bool operator!=(Constraint const& lhs, Constraint const& rhs)
+{
+	return !(lhs == rhs);
+}
+
+/**
+ * \brief Counters describing the behaviour of a Layout.
+ */
+struct LayoutStats
+{
+	std::size_t applies;  ///< Calls to Layout::apply().
+	std::size_t solved;   ///< Nodes whose children had their geometry computed again.
+	std::size_t created;  ///< Subwindows created.
+	std::size_t moved;    ///< Subwindows moved, including the ones moved along with their parent.
+	std::size_t resized;  ///< Subwindows resized.
+	std::size_t deleted;  ///< Subwindows deleted because their node became empty.
+};
+
+/**
+ * \brief Tree of subwindows sized by constraints.
+ * 
+ * Each node but the root owns a Subwindow of the window of its parent node. A node lays its
+ * children out in a row (from left to right) or in a column (from top to bottom), according to
+ * their constraints:
+ * \code
+ * nccpp::Layout layout{nccpp::ncurses(), nccpp::Layout::Direction::column};
+ * auto title = layout.add(layout.root(), nccpp::Constraint::fixed(1));
+ * auto body = layout.add(layout.root(), nccpp::Constraint::fill(), nccpp::Layout::Direction::row);
+ * auto side = layout.add(body, nccpp::Constraint::percentage(25));
+ * auto main = layout.add(body, nccpp::Constraint::fill());
+ * layout.apply();
+ * \endcode
+ * 
+ * apply() is incremental: the children of a node are only computed again if the size of the node
+ * or their constraints changed, and subtrees whose geometry didn't change aren't visited. Existing
+ * subwindows are moved with mvderwin and mvwin and resized with wresize, never created again.
+ * A node whose size becomes empty has no subwindow until it gets some space back.
+ * Subwindows share the cells of the root window, so what was drawn stays in place when a node is
+ * moved: nodes whose geometry changed must be drawn again after apply().
+ */
+class Layout
+{
+	public:
+	/**
+	 * \brief Direction in which a node lays its children out.
+	 */
+	enum class Direction
+	{
+		row,   ///< From left to right.
+		column ///< From top to bottom.
+	};
+
+	/// Identifier of a node. The root is 0.
+	using Node = std::size_t;
+
+	explicit Layout(Window&, Direction = Direction::column);
+
+	/// \cond NODOC
+	Layout(Layout const&) = delete;
+	Layout& operator=(Layout const&) = delete;
+
+	Layout(Layout&&) = delete;
+	Layout& operator=(Layout&&) = delete;
+	/// \endcond
+
+	~Layout();
+
+	Node root() const;
+	Node add(Node, Constraint, Direction = Direction::column);
+	std::size_t node_count() const;
+
+	void set_constraint(Node, Constraint);
+	void set_direction(Node, Direction);
+
+	bool has_window(Node) const;
+	Window& get_window(Node);
+
+	int apply();
+
+	LayoutStats const& layout_stats() const;
+	void reset_layout_stats();
+
+	private:
+	/// \cond NODOC
+	struct Rect
+	{
+		int y;
+		int x;
+		int lines;
+		int cols;
+	};
+
+	struct NodeData
+	{
+		Node parent;
+		std::vector<Node> children;
+		Constraint constraint;
+		Direction direction;
+		Rect rect; // Relative to the window of the parent
+		SubwindowHandle handle;
+		Subwindow* window;
+		bool dirty;         // The children must be computed again
+		bool dirty_subtree; // A descendant is dirty
+	};
+	/// \endcond
+
+	Window& root_;
+	std::vector<NodeData> nodes_;
+	LayoutStats stats_;
+
+	void mark_dirty_(Node);
+	void solve_(Node);
+	int update_(Node, bool);
+	int place_(Node, Window&, bool, bool&);
+	void release_(Node);
+	void forget_(Node);
+};
+
+} // namespace nccpp
+
+#include "Layout.ipp"
+
+#endif // Header guard
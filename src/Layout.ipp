@@ -0,0 +1,397 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+#ifndef NCURSESCPP_LAYOUT_IPP_
+#define NCURSESCPP_LAYOUT_IPP_
+
+#include <algorithm>
+#include <cassert>
+
+namespace nccpp
+{
+
+/**
+ * \brief Create a layout with only a root node.
+ * 
+ * No subwindow is created until apply() is called.
+ * 
+ * \param root The window covered by the root node. It must outlive the layout.
+ * \param direction The direction in which the root lays its children out.
+ * \pre The Window manages a ncurses window.
+ */
+inline Layout::Layout(Window& root, Direction direction)
+	: root_{root}, nodes_{}, stats_{0, 0, 0, 0, 0, 0}
+{
+	nodes_.push_back(NodeData{0, {}, Constraint::fill(), direction, Rect{0, 0, 0, 0}, SubwindowHandle{}, nullptr,
+	                          true, false});
+}
+
+/**
+ * \brief Destroy the layout and every subwindow it created.
+ */
+inline Layout::~Layout()
+{
+	for (auto child : nodes_[0].children)
+		if (nodes_[child].window)
+			root_.delete_subwindow(nodes_[child].handle);
+}
+
+/**
+ * \brief Get the root node.
+ * 
+ * \return The root node, which covers the whole root window.
+ */
+inline Layout::Node Layout::root() const
+{
+	return 0;
+}
+
+/**
+ * \brief Add a node as the last child of another one.
+ * 
+ * \param parent The parent node.
+ * \param constraint The size of the node along the direction of its parent.
+ * \param direction The direction in which the node lays its own children out.
+ * \pre *parent* is a node of the layout.
+ * \return The new node.
+ */
+inline Layout::Node Layout::add(Node parent, Constraint constraint, Direction direction)
+{
+	assert(parent < nodes_.size() && "Invalid layout node");
+	auto node = nodes_.size();
+	nodes_.push_back(NodeData{parent, {}, constraint, direction, Rect{0, 0, 0, 0}, SubwindowHandle{}, nullptr,
+	                          true, false});
+	nodes_[parent].children.push_back(node);
+	mark_dirty_(parent);
+	return node;
+}
+
+/**
+ * \brief Get the number of nodes, the root included.
+ * 
+ * \return The number of nodes.
+ */
+inline std::size_t Layout::node_count() const
+{
+	return nodes_.size();
+}
+
+/**
+ * \brief Change the constraint of a node.
+ * 
+ * The new geometry is applied by the next call to apply().
+ * 
+ * \param node The node.
+ * \param constraint The new constraint.
+ * \pre *node* is a node of the layout, other than the root.
+ */
+inline void Layout::set_constraint(Node node, Constraint constraint)
+{
+	assert(node < nodes_.size() && "Invalid layout node");
+	assert(node != 0 && "The root node has no constraint");
+	auto& data = nodes_[node];
+	if (data.constraint == constraint)
+		return;
+	data.constraint = constraint;
+	mark_dirty_(data.parent);
+}
+
+/**
+ * \brief Change the direction in which a node lays its children out.
+ * 
+ * The new geometry is applied by the next call to apply().
+ * 
+ * \param node The node.
+ * \param direction The new direction.
+ * \pre *node* is a node of the layout.
+ */
+inline void Layout::set_direction(Node node, Direction direction)
+{
+	assert(node < nodes_.size() && "Invalid layout node");
+	auto& data = nodes_[node];
+	if (data.direction == direction)
+		return;
+	data.direction = direction;
+	mark_dirty_(node);
+}
+
+/**
+ * \brief Check if a node has a window.
+ * 
+ * The root always has one. Other nodes have one once apply() gave them a non-empty size.
+ * 
+ * \param node The node.
+ * \pre *node* is a node of the layout.
+ * \return true if the node has a window, false otherwise.
+ */
+inline bool Layout::has_window(Node node) const
+{
+	assert(node < nodes_.size() && "Invalid layout node");
+	return node == 0 || nodes_[node].window;
+}
+
+/**
+ * \brief Get the window of a node.
+ * 
+ * The reference stays valid until the node loses its window, because its size became empty, or
+ * the layout is destroyed.
+ * 
+ * \param node The node.
+ * \pre *node* has a window.
+ * \return The root window for the root, the subwindow of the node otherwise.
+ */
+inline Window& Layout::get_window(Node node)
+{
+	assert(has_window(node) && "Layout node has no window");
+	return node == 0 ? root_ : *nodes_[node].window;
+}
+
+/**
+ * \brief Compute the geometry of the nodes and update the subwindows.
+ * 
+ * Only the nodes whose constraints changed or whose parent was moved or resized since the previous
+ * call are visited. Subwindows are created the first time their node gets a non-empty size, and
+ * deleted, with their subtree, when it becomes empty.
+ * 
+ * \pre The root window manages a ncurses window.
+ * \exception errors::WindowInit Thrown if a subwindow can't be created.
+ * \return The result of the operation.
+ */
+inline int Layout::apply()
+{
+	++stats_.applies;
+	auto& root = nodes_[0];
+	auto handle = root_.get_handle();
+	Rect rect{getbegy(handle), getbegx(handle), getmaxy(handle), getmaxx(handle)};
+	bool changed{false};
+	if (rect.lines != root.rect.lines || rect.cols != root.rect.cols)
+	{
+		root.dirty = true;
+		changed = true;
+	}
+	else if (rect.y != root.rect.y || rect.x != root.rect.x)
+		changed = true;
+	root.rect = rect;
+	return update_(0, changed);
+}
+
+/**
+ * \brief Get the layout counters.
+ * 
+ * \return The counters accumulated since the last reset.
+ */
+inline LayoutStats const& Layout::layout_stats() const
+{
+	return stats_;
+}
+
+/**
+ * \brief Reset the layout counters.
+ */
+inline void Layout::reset_layout_stats()
+{
+	stats_ = LayoutStats{0, 0, 0, 0, 0, 0};
+}
+
+/// \cond NODOC
+inline void Layout::mark_dirty_(Node node)
+{
+	nodes_[node].dirty = true;
+	while (node != 0)
+	{
+		node = nodes_[node].parent;
+		if (nodes_[node].dirty_subtree)
+			break;
+		nodes_[node].dirty_subtree = true;
+	}
+}
+
+// Compute the rects of the children from the size of the node
+inline void Layout::solve_(Node node)
+{
+	++stats_.solved;
+	auto const& data = nodes_[node];
+	bool row{data.direction == Direction::row};
+	int total{row ? data.rect.cols : data.rect.lines};
+	int cross{row ? data.rect.lines : data.rect.cols};
+
+	// Fixed and percentage sizes are served in order, fills share what is left
+	int left{total}, weights{0};
+	for (auto child : data.children)
+	{
+		auto& c = nodes_[child];
+		int size{0};
+		if (c.constraint.type == Constraint::Type::fixed)
+			size = c.constraint.value;
+		else if (c.constraint.type == Constraint::Type::percentage)
+			size = total * c.constraint.value / 100;
+		else
+			weights += std::max(c.constraint.value, 0);
+		size = std::max(0, std::min(size, left));
+		left -= size;
+		(row ? c.rect.cols : c.rect.lines) = size;
+	}
+	int weight_before{0}, pos{0};
+	for (auto child : data.children)
+	{
+		auto& c = nodes_[child];
+		int& size = row ? c.rect.cols : c.rect.lines;
+		if (c.constraint.type == Constraint::Type::fill && weights != 0)
+		{
+			auto weight = std::max(c.constraint.value, 0);
+			size = left * (weight_before + weight) / weights - left * weight_before / weights;
+			weight_before += weight;
+		}
+		(row ? c.rect.lines : c.rect.cols) = cross;
+		(row ? c.rect.x : c.rect.y) = pos;
+		(row ? c.rect.y : c.rect.x) = 0;
+		pos += size;
+	}
+}
+
+// Visit the children of a node whose own window is up to date
+inline int Layout::update_(Node node, bool changed)
+{
+	auto& data = nodes_[node];
+	bool solved{data.dirty};
+	if (solved && !data.children.empty())
+		solve_(node);
+	data.dirty = false;
+	data.dirty_subtree = false;
+
+	auto& win = node == 0 ? root_ : *data.window;
+	int ret{OK};
+	for (auto child : data.children)
+	{
+		auto& c = nodes_[child];
+		if (c.rect.lines <= 0 || c.rect.cols <= 0)
+		{
+			if (c.window)
+				release_(child);
+			continue;
+		}
+		bool child_changed{false};
+		if (!c.window || changed || solved)
+			if (place_(child, win, changed, child_changed) == ERR)
+				ret = ERR;
+		if (child_changed || c.dirty || c.dirty_subtree)
+			if (update_(child, child_changed) == ERR)
+				ret = ERR;
+	}
+	return ret;
+}
+
+// Create, move or resize the subwindow of a node to match its rect
+inline int Layout::place_(Node node, Window& parent, bool parent_changed, bool& changed)
+{
+	auto& data = nodes_[node];
+	auto const& rect = data.rect;
+	auto parent_handle = parent.get_handle();
+	int beg_y{getbegy(parent_handle) + rect.y}, beg_x{getbegx(parent_handle) + rect.x};
+	if (!data.window)
+	{
+		data.handle = parent.add_subwindow(rect.lines, rect.cols, beg_y, beg_x);
+		data.window = &parent.get_subwindow(data.handle);
+		data.dirty = true;
+		changed = true;
+		++stats_.created;
+		return OK;
+	}
+
+	auto handle = data.window->get_handle();
+	int lines{getmaxy(handle)}, cols{getmaxx(handle)};
+	bool resize{lines != rect.lines || cols != rect.cols};
+	// mvderwin doesn't update the subwindows of the moved window, so they're moved along with it
+	bool move{parent_changed || getpary(handle) != rect.y || getparx(handle) != rect.x ||
+	          getbegy(handle) != beg_y || getbegx(handle) != beg_x};
+	if (!resize && !move)
+		return OK;
+
+	int ret{OK};
+	auto& win = *data.window;
+	// The window must fit in its parent at every step
+	int par_lines{getmaxy(parent_handle)}, par_cols{getmaxx(parent_handle)};
+	if (move && resize && (getpary(handle) + rect.lines > par_lines || getparx(handle) + rect.cols > par_cols))
+	{
+		if ((rect.y + lines > par_lines || rect.x + cols > par_cols) &&
+		    win.resize(std::min(lines, rect.lines), std::min(cols, rect.cols)) == ERR)
+			ret = ERR;
+		if (win.move_to(rect.y, rect.x) == ERR)
+			ret = ERR;
+		++stats_.moved;
+		move = false;
+	}
+	if (resize)
+	{
+		if (win.resize(rect.lines, rect.cols) == ERR)
+			ret = ERR;
+		data.dirty = true;
+		++stats_.resized;
+	}
+	if (move)
+	{
+		if (win.move_to(rect.y, rect.x) == ERR)
+			ret = ERR;
+		++stats_.moved;
+	}
+	changed = true;
+	return ret;
+}
+
+inline void Layout::release_(Node node)
+{
+	auto& data = nodes_[node];
+	get_window(data.parent).delete_subwindow(data.handle);
+	forget_(node);
+	++stats_.deleted;
+}
+
+// The subwindows of the subtree were deleted along with the subwindow of the node
+inline void Layout::forget_(Node node)
+{
+	auto& data = nodes_[node];
+	data.window = nullptr;
+	data.handle = SubwindowHandle{};
+	data.dirty = true;
+	for (auto child : data.children)
+		if (nodes_[child].window)
+			forget_(child);
+}
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
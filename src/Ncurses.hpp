@@ -45,7 +45,11 @@
 #define NCCPP_NCURSES_DELAYED_IMPL
 #endif
 
-#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
 
 #ifndef NCCPP_WINDOW_NOIMPL
 #define NCCPP_WINDOW_NOIMPL
@@ -55,7 +59,16 @@
 #include "Window.hpp"
 #endif
 
-#include "Color.hpp"
+#include "OutputSink.hpp"
+#include "VirtualTerminal.hpp"
+
+#ifndef NCCPP_SCREEN_NOIMPL
+#define NCCPP_SCREEN_NOIMPL
+#include "Screen.hpp"
+#undef NCCPP_SCREEN_NOIMPL
+#else
+#include "Screen.hpp"
+#endif
 
 namespace nccpp
 {
@@ -64,9 +77,10 @@ namespace nccpp
  * \brief The primary interface class.
  * 
  * This class is used to access ncurses features.
- * It is responsible of the initialization of ncurses.
+ * It is responsible of the initialization of ncurses, and is the Screen of the terminal of the process.
+ * Its functions act on that screen even when another Screen is current.
  */
-class Ncurses : public Window
+class Ncurses : public Screen
 {
 	friend Ncurses& ncurses();
 	public:
@@ -80,29 +94,16 @@ class Ncurses : public Window
 	~Ncurses();
 	/// \endcond
 
-	void exit_ncurses_mode();
-	void resume_ncurses_mode();
+	void exit_ncurses_mode() override;
+	void resume_ncurses_mode() override;
 
 	// Input options
 
-	int cbreak(bool);
-	int echo(bool);
-	int halfdelay(int);
-	int intrflush(bool);
-	int meta(bool);
-	int raw(bool);
-	void qiflush(bool);
-	int typeahead(int);
-
-	// Output options
-
-	int clearok(bool, bool = false);
-	int idlok(bool);
-	void idcok(bool);
-	void immedok(bool);
-	int leaveok(bool);
-	int scrollok(bool);
-	int nl(bool);
+	int cbreak(bool) override;
+	int halfdelay(int) override;
+	int intrflush(bool) override;
+	int raw(bool) override;
+	void qiflush(bool) override;
 
 	// Input functions
 
@@ -111,9 +112,10 @@ class Ncurses : public Window
 
 	// Misc
 
-	int doupdate();
-	int line_count();
-	int column_count();
+	VirtualTerminal* get_virtual_terminal();
+	OutputSink* get_output_sink();
+
+	int update_terminal_size() override;
 
 	// Mouse
 
@@ -123,41 +125,39 @@ class Ncurses : public Window
 	mmask_t mousemask(mmask_t, mmask_t* = nullptr);
 	int mouseinterval(int);
 
-	// Window
-
 	/// \cond NODOC
-	WINDOW* newwin_(int, int, int, int, Window::Key);
-#ifndef NDEBUG
-	void register_window_(Window&, Window::Key);
-	void unregister_window_(Window&, Window::Key);
-#endif
+	void end_frame_(Window::Key) override;
 	/// \endcond
 
-	// Color
+	private:
+	Ncurses();
 
-	void start_color();
-	int use_default_colors();
+	static WINDOW* init_screen_();
 
-	short color_to_pair_number(Color const&);
-	attr_t color_to_attr(Color const&);
-	Color pair_number_to_color(short);
-	Color attr_to_color(attr_t);
+	std::unique_ptr<VirtualTerminal> terminal_;
+	std::unique_ptr<OutputSink> sink_;
+};
 
-	int init_color(short, short, short, short);
+/// \cond NODOC
+namespace internal
+{
 
-	private:
-	Ncurses();
+struct StartupOptions
+{
+	std::unique_ptr<VirtualTerminal> terminal;
+	std::unique_ptr<OutputSink> sink;
+	SCREEN* screen;
+	bool started;
+};
 
-	std::vector<Color> registered_colors_;
-#ifndef NDEBUG
-	std::vector<Window*> windows_;
-	bool is_exit_;
-#endif
-	bool colors_initialized_;
+inline StartupOptions& startup_options()
+{
+	static StartupOptions opts{nullptr, nullptr, nullptr, false};
+	return opts;
+}
 
-	void assign(WINDOW*) override;
-	void destroy() override;
-};
+} // namespace internal
+/// \endcond
 
 /**
  * Access the Ncurses singleton.
@@ -171,6 +171,59 @@ inline Ncurses& ncurses()
 	return nc;
 }
 
+/// \cond NODOC
+namespace internal
+{
+
+// Screen the library works on, the Ncurses singleton unless another screen has been made current
+inline Screen& current_screen()
+{
+	if (auto screen = current_screen_ptr())
+		return *screen;
+	auto& nc = ncurses();
+	nc.make_current();
+	return nc;
+}
+
+} // namespace internal
+/// \endcond
+
+/**
+ * \brief Bind ncurses to a VirtualTerminal instead of the real tty.
+ * 
+ * The terminal is owned by the Ncurses singleton and can be accessed with
+ * Ncurses::get_virtual_terminal().
+ * 
+ * \param lines,cols Size of the terminal.
+ * \param type Terminal type, as in the TERM environment variable.
+ * \pre The Ncurses singleton hasn't been created yet.
+ * \exception errors::TerminalInit Thrown if the terminal can't be created.
+ */
+inline void use_virtual_terminal(int lines, int cols, std::string type = "xterm-256color")
+{
+	assert(!internal::startup_options().started && "Ncurses is already initialized");
+	assert(!internal::startup_options().sink && "Ncurses already uses an output sink");
+	internal::startup_options().terminal.reset(new VirtualTerminal{lines, cols, std::move(type)});
+}
+
+/**
+ * \brief Route the output of ncurses through an OutputSink.
+ * 
+ * Each frame is sent to the tty with a single write instead of one write per few kilobytes.
+ * The sink is owned by the Ncurses singleton and can be accessed with Ncurses::get_output_sink().
+ * 
+ * \param buffer_size Number of bytes buffered before a flush is forced in the middle of a frame.
+ * \param fd File descriptor of the tty.
+ * \pre The Ncurses singleton hasn't been created yet.
+ * \exception errors::OutputSinkInit Thrown if the sink can't be created.
+ */
+inline void use_output_sink(std::size_t buffer_size = 1 << 18, int fd = STDOUT_FILENO)
+{
+	assert(!internal::startup_options().started && "Ncurses is already initialized");
+	assert(!internal::startup_options().terminal && "Ncurses already uses a virtual terminal");
+	internal::startup_options().sink.reset(new OutputSink{buffer_size, fd});
+}
+
 } // namespace nccpp
 
 #ifndef NCCPP_NCURSES_NOIMPL
@@ -180,7 +233,9 @@ inline Ncurses& ncurses()
 #undef NCCPP_NCURSES_DELAYED_IMPL
 #endif
 
+#include "Screen.ipp"
 #include "Ncurses.ipp"
+#include "FrameScheduler.ipp"
 #endif
 
 #endif // Header guard
@@ -36,8 +36,10 @@
 #ifndef NCURSESCPP_NCURSES_IPP_
 #define NCURSESCPP_NCURSES_IPP_
 
-#include <algorithm>
 #include <cassert>
+#include <cstdio>
+
+#include <unistd.h>
 
 #include "errors.hpp"
 
@@ -45,54 +47,72 @@ namespace nccpp
 {
 
 inline Ncurses::Ncurses()
-	: Window{initscr()}, registered_colors_{},
-#ifndef NDEBUG
-	  windows_{}, is_exit_{false},
-#endif
-	  colors_initialized_{false}
+	: Screen{init_screen_(), internal::startup_options().screen},
+	  terminal_{std::move(internal::startup_options().terminal)}, sink_{std::move(internal::startup_options().sink)}
 {
 	if (!win_)
 		throw errors::NcursesInit{};
+	input_fd_ = fileno(terminal_ ? terminal_->in_file_ : stdin);
+	output_fd_ = STDOUT_FILENO;
 }
 
 inline Ncurses::~Ncurses()
 {
-	endwin();
-	win_ = nullptr;
+	// The sink and the terminal must outlive the screen, so it's ended here rather than by ~Screen
+	make_current();
+	if (screen_)
+		end_screen_();
 #ifdef NO_LEAKS
 	_nc_freeall();
 #endif
 }
 
-#ifndef NDEBUG
-inline void Ncurses::register_window_(Window& new_win, Window::Key /*dummy*/)
-{
-	windows_.push_back(&new_win);
+inline WINDOW* Ncurses::init_screen_()
+{
+	auto& opts = internal::startup_options();
+	opts.started = true;
+	if (opts.sink)
+	{
+		auto& sink = *opts.sink;
+		opts.screen = newterm(nullptr, sink.out_file_, stdin);
+		if (!opts.screen)
+			return nullptr;
+		// Ncurses can't query the size of a pipe
+		auto lines = sink.line_count(), cols = sink.column_count();
+		if (lines > 0 && cols > 0)
+			resize_term(lines, cols);
+		sink.resume_();
+		return stdscr;
+	}
+	if (!opts.terminal)
+	{
+		// Same as initscr, which exits instead of failing and doesn't give the screen
+		opts.screen = newterm(nullptr, stdout, stdin);
+		if (!opts.screen)
+			return nullptr;
+		def_prog_mode();
+		return stdscr;
+	}
+	auto& term = *opts.terminal;
+	opts.screen = newterm(term.type_.c_str(), term.out_file_, term.in_file_);
+	if (!opts.screen)
+		return nullptr;
+	resize_term(term.lines_, term.cols_);
+	return stdscr;
 }
 
-inline void Ncurses::unregister_window_(Window& win, Window::Key /*dummy*/)
-{
-	auto it = std::find(std::begin(windows_), std::end(windows_), &win);
-	assert(it != std::end(windows_));
-	windows_.erase(it);
-}
-#endif
-
 /**
  * \brief Exit ncurses mode and restore normal terminal properties.
  * 
+ * The output sink, if any, gives the terminal back as well.
+ * 
  * \pre %Ncurses mode is on.
  */
 inline void Ncurses::exit_ncurses_mode()
 {
-	assert(!is_exit_ && "Ncurses mode is already off");
-#ifndef NDEBUG
-	for (auto elem : windows_)
-		elem->invalidate_for_exit_(Window::Key{});
-	invalidate_for_exit_(Key{});
-	is_exit_ = true;
-#endif
-	endwin();
+	Screen::exit_ncurses_mode();
+	if (sink_)
+		sink_->suspend_();
 }
 
 /**
@@ -102,14 +122,9 @@ inline void Ncurses::exit_ncurses_mode()
  */
 inline void Ncurses::resume_ncurses_mode()
 {
-	assert(is_exit_ && "Ncurses mode is already on");
-#ifndef NDEBUG
-	for (auto elem : windows_)
-		elem->validate_for_resume_(Window::Key{});
-	validate_for_resume_(Key{});
-	is_exit_ = false;
-#endif
-	doupdate();
+	if (sink_)
+		sink_->resume_();
+	Screen::resume_ncurses_mode();
 }
 
 // Input options
@@ -117,6 +132,8 @@ inline void Ncurses::resume_ncurses_mode()
 /**
  * \brief Change cbreak mode.
  * 
+ * With an output sink, the mode of the sink's terminal is changed instead.
+ * 
  * \param on If true, call cbreak. Else, call nocbreak.
  * \pre %Ncurses mode is on.
  * \return The result of the operation.
@@ -124,25 +141,16 @@ inline void Ncurses::resume_ncurses_mode()
 inline int Ncurses::cbreak(bool on)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
-	return on ? ::cbreak() : nocbreak();
-}
-
-/**
- * \brief Change echo mode.
- * 
- * \param on If true, call echo. Else, call noecho.
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::echo(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return on ? ::echo() : noecho();
+	if (sink_)
+		return sink_->cbreak_(on);
+	return Screen::cbreak(on);
 }
 
 /**
  * \brief Call halfdelay.
  * 
+ * With an output sink, the sink's terminal is put in cbreak mode first.
+ * 
  * \param delay Value to pass on to halfdelay.
  * \pre %Ncurses mode is on.
  * \return The result of the operation.
@@ -150,12 +158,16 @@ inline int Ncurses::echo(bool on)
 inline int Ncurses::halfdelay(int delay)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
-	return ::halfdelay(delay);
+	if (sink_ && sink_->cbreak_(true) == ERR)
+		return ERR;
+	return Screen::halfdelay(delay);
 }
 
 /**
  * \brief Call intrflush.
  * 
+ * With an output sink, the mode of the sink's terminal is changed instead.
+ * 
  * \param on Value to pass on to intrflush.
  * \pre %Ncurses mode is on.
  * \return The result of the operation.
@@ -163,25 +175,16 @@ inline int Ncurses::halfdelay(int delay)
 inline int Ncurses::intrflush(bool on)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
-	return ::intrflush(win_, on);
-}
-
-/**
- * \brief Call meta.
- * 
- * \param on Value to pass on to meta.
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::meta(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return ::meta(win_, on);
+	if (sink_)
+		return sink_->flush_on_interrupt_(on);
+	return Screen::intrflush(on);
 }
 
 /**
  * \brief Change raw mode.
  * 
+ * With an output sink, the mode of the sink's terminal is changed instead.
+ * 
  * \param on If true, call raw. Else, call noraw.
  * \pre %Ncurses mode is on.
  * \return The result of the operation.
@@ -189,123 +192,26 @@ inline int Ncurses::meta(bool on)
 inline int Ncurses::raw(bool on)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
-	return on ? ::raw() : noraw();
+	if (sink_)
+		return sink_->raw_(on);
+	return Screen::raw(on);
 }
 
 /**
  * \brief Change qiflush mode.
  * 
+ * With an output sink, the mode of the sink's terminal is changed instead.
+ * 
  * \param on If true, call qiflush. Else, call noquiflush.
  * \pre %Ncurses mode is on.
  */
 inline void Ncurses::qiflush(bool on)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
-	on ? ::qiflush() : noqiflush();
-}
-
-/**
- * \brief Call typeahead.
- * 
- * \param fd Value to pass on to typeahead.
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::typeahead(int fd)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return ::typeahead(fd);
-}
-
-// Output options
-
-/**
- * \brief Call clearok.
- * 
- * \param on Value to pass on to clearok.
- * \param use_cs If true, call clearok with *curscr* as argument.
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::clearok(bool on, bool use_cs)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return::clearok(use_cs ? curscr : win_, on);
-}
-
-/**
- * \brief Call idlok.
- * 
- * \param on Value to pass on to idlok.
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::idlok(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return ::idlok(win_, on);
-}
-
-/**
- * \brief Call idcok.
- * 
- * \param on Value to pass on to idcok.
- * \pre %Ncurses mode is on.
- */
-inline void Ncurses::idcok(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	::idcok(win_, on);
-}
-
-/**
- * \brief Call immedok.
- * 
- * \param on Value to pass on to immedok.
- * \pre %Ncurses mode is on.
- */
-inline void Ncurses::immedok(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	::immedok(win_, on);
-}
-
-/**
- * \brief Call leaveok.
- * 
- * \param on Value to pass on to leaveok.
- * \pre %Ncurses mode is on.
- */
-inline int Ncurses::leaveok(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return ::leaveok(win_, on);
-}
-
-/**
- * \brief Call scrollok.
- * 
- * \param on Value to pass on to scrollok.
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::scrollok(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return ::scrollok(win_, on);
-}
-
-/**
- * \brief Change nl mode.
- * 
- * \param on If true, call nl. Else, call nonl.
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::nl(bool on)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return on ? ::nl() : nonl();
+	if (sink_)
+		sink_->flush_on_interrupt_(on);
+	else
+		Screen::qiflush(on);
 }
 
 // Input functions
@@ -320,6 +226,7 @@ inline int Ncurses::nl(bool on)
 inline int Ncurses::ungetch(int ch)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
 	return ::ungetch(ch);
 }
 
@@ -333,45 +240,51 @@ inline int Ncurses::ungetch(int ch)
 inline int Ncurses::has_key(int ch)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
 	return ::has_key(ch);
 }
 
 // Misc
 
 /**
- * \brief Call doupdate.
+ * \brief Get the virtual terminal ncurses is bound to.
  * 
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
+ * \return The terminal set up by use_virtual_terminal(), or nullptr if ncurses uses the real tty.
  */
-inline int Ncurses::doupdate()
+inline VirtualTerminal* Ncurses::get_virtual_terminal()
 {
-	assert(!is_exit_ && "Ncurses mode is off");
-	return ::doupdate();
+	return terminal_.get();
 }
 
 /**
- * \brief Get the height of the terminal.
+ * \brief Get the output sink ncurses writes to.
  * 
- * \pre %Ncurses mode is on.
- * \return The number of lines of the terminal.
+ * \return The sink set up by use_output_sink(), or nullptr if ncurses writes to the tty directly.
  */
-inline int Ncurses::line_count()
+inline OutputSink* Ncurses::get_output_sink()
 {
-	assert(!is_exit_ && "Ncurses mode is off");
-	return LINES;
+	return sink_.get();
 }
 
 /**
- * \brief Get the width of the terminal.
+ * \brief Resize the screen to the size of the terminal, if it changed.
+ * 
+ * When ncurses writes to the tty, it does it by itself before returning KEY_RESIZE. It can't query
+ * the size through an OutputSink or a VirtualTerminal, so the size is queried from them instead, and
+ * from the standard output otherwise.
+ * Unlike resizeterm(), no KEY_RESIZE is queued. The whole screen is redrawn by the next update.
  * 
  * \pre %Ncurses mode is on.
- * \return The number of columns of the terminal.
+ * \return The result of the operation.
  */
-inline int Ncurses::column_count()
+inline int Ncurses::update_terminal_size()
 {
 	assert(!is_exit_ && "Ncurses mode is off");
-	return COLS;
+	if (sink_)
+		return resize_to_(sink_->line_count(), sink_->column_count());
+	if (terminal_)
+		return resize_to_(terminal_->line_count(), terminal_->column_count());
+	return Screen::update_terminal_size();
 }
 
 // Mouse
@@ -385,6 +298,7 @@ inline int Ncurses::column_count()
 inline bool Ncurses::has_mouse()
 {
 	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
 	return ::has_mouse();
 }
 
@@ -398,6 +312,7 @@ inline bool Ncurses::has_mouse()
 inline int Ncurses::getmouse(MEVENT& event)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
 	return ::getmouse(&event);
 }
 
@@ -411,6 +326,7 @@ inline int Ncurses::getmouse(MEVENT& event)
 inline int Ncurses::ungetmouse(MEVENT& event)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
 	return ::ungetmouse(&event);
 }
 
@@ -424,6 +340,7 @@ inline int Ncurses::ungetmouse(MEVENT& event)
 inline mmask_t Ncurses::mousemask(mmask_t newmask, mmask_t* oldmask)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
 	return ::mousemask(newmask, oldmask);
 }
 
@@ -437,139 +354,16 @@ inline mmask_t Ncurses::mousemask(mmask_t newmask, mmask_t* oldmask)
 inline int Ncurses::mouseinterval(int erval)
 {
 	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
 	return ::mouseinterval(erval);
 }
 
-// Window
-
-inline WINDOW* Ncurses::newwin_(int nlines, int ncols, int begin_y, int begin_x, Window::Key /*dummy*/)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return newwin(nlines, ncols, begin_y, begin_x);
-}
-
-// Color
-
-/**
- * \brief Start ncurses color mode.
- * 
- * \pre %Ncurses mode is on.
- * \exception errors::ColorInit Thrown when colors can't be initialized.
- */
-inline void Ncurses::start_color()
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	if (colors_initialized_)
-		return;
-	if (::start_color() == ERR)
-		throw errors::ColorInit{};
-	colors_initialized_ = true;
-}
-
-/**
- * \brief Call use_default_colors.
- * 
- * \pre %Ncurses mode is on.
- * \return The result of the operation.
- */
-inline int Ncurses::use_default_colors()
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	start_color();
-	return ::use_default_colors();
-}
-
-/**
- * \brief Get a pair number from a Color.
- * 
- * \param color The color to get.
- * \pre %Ncurses mode is on.
- * \exception errors::TooMuchColors Thrown if no more color pairs can be registered.
- * \return The pair number associated with the color.
- */
-inline short Ncurses::color_to_pair_number(Color const& color)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	auto it = std::find_if(std::begin(registered_colors_), std::end(registered_colors_),
-	                       [color](Color const& elem){return color == elem;});
-	if (it != std::end(registered_colors_))
-		return static_cast<short>(it - std::begin(registered_colors_) + 1);
-
-	start_color();
-	// Ensure push_back will not throw
-	registered_colors_.reserve(registered_colors_.size() + 1);
-	auto res = init_pair(static_cast<short>(registered_colors_.size() + 1),
-	                     color.foreground, color.background);
-	if (res == ERR)
-		throw errors::TooMuchColors{color};
-	registered_colors_.push_back(color);
-	return static_cast<short>(registered_colors_.size());
-}
-
-/**
- * \brief Get an attribute character from a Color.
- * 
- * \param color The color to get.
- * \pre %Ncurses mode is on.
- * \exception errors::TooMuchColors Thrown if no more color pairs can be registered.
- * \return The attribute associated with the color.
- */
-inline attr_t Ncurses::color_to_attr(Color const& color)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return static_cast<attr_t>(COLOR_PAIR(color_to_pair_number(color)));
-}
-
-/**
- * \brief Get a Color from a pair number.
- * 
- * \param pair_n The pair number.
- * \pre %Ncurses mode is on.
- * \pre *pair_n* is a valid pair number.
- * \return The color associated with the pair.
- */
-inline Color Ncurses::pair_number_to_color(short pair_n)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	assert(static_cast<std::size_t>(pair_n) <= registered_colors_.size() && "No such color");
-	return registered_colors_[static_cast<std::size_t>(pair_n - 1)];
-}
-
-/**
- * \brief Get a Color from an attribute.
- * 
- * \param a The attribute.
- * \pre %Ncurses mode is on.
- * \pre The color pair associated with *a* is a valid color attribute.
- * \return The color associated with the attribute.
- */
-inline Color Ncurses::attr_to_color(attr_t a)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	return pair_number_to_color(static_cast<short>(PAIR_NUMBER(static_cast<int>(a))));
-}
-
-/**
- * \brief Call init_color.
- * 
- * \pre %Ncurses mode is on.
- * \param color,r,g,b Values to pass on to init_color.
- */
-inline int Ncurses::init_color(short color, short r, short g, short b)
-{
-	assert(!is_exit_ && "Ncurses mode is off");
-	start_color();
-	return ::init_color(color, r, g, b);
-}
-
-inline void Ncurses::assign(WINDOW*)
-{
-	assert(false && "Can't call nccpp::Ncurses::assign");
-}
-
-inline void Ncurses::destroy()
+inline void Ncurses::end_frame_(Window::Key /*dummy*/)
 {
-	assert(false && "Can't call nccpp::Ncurses::destroy");
+	if (terminal_)
+		terminal_->end_frame_();
+	else if (sink_)
+		sink_->end_frame_();
 }
 
 
@@ -0,0 +1,150 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+/**
+ * \file OutputSink.hpp
+ * \brief Header file for the OutputSink class.
+ */
+
+#ifndef NCURSESCPP_OUTPUTSINK_HPP_
+#define NCURSESCPP_OUTPUTSINK_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <termios.h>
+#include <unistd.h>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Counters describing the writes of an OutputSink to the terminal.
+ */
+struct OutputSinkStats
+{
+	std::size_t frames;              ///< Frames flushed, one per Ncurses::doupdate() or Window::refresh().
+	std::size_t syscalls;            ///< Writes to the terminal.
+	std::size_t bytes;               ///< Bytes written to the terminal.
+	std::size_t overflows;           ///< Flushes forced because the buffer was full before the end of a frame.
+	std::size_t last_frame_syscalls; ///< Writes since the end of the previous frame, up to the end of the last one.
+	std::size_t last_frame_bytes;    ///< Bytes written since the end of the previous frame, up to the end of the last one.
+};
+
+/**
+ * \brief Library-owned buffer between ncurses and the tty.
+ * 
+ * The sink is created by use_output_sink() and owned by the Ncurses singleton.
+ * Ncurses writes each frame in chunks of a few kilobytes; the sink collects them and sends the whole frame to
+ * the tty with a single write when the frame ends.
+ * 
+ * Ncurses is bound to a pipe, so the sink also sets the terminal modes (cbreak, raw, etc) of the tty on its
+ * behalf. Calling the ncurses mode functions directly, instead of the Ncurses ones, has no effect.
+ * Screen::echo(), Screen::meta() and Screen::nl() don't change the tty modes, ncurses handles them itself, so
+ * they work as usual.
+ * The tty is restored when ncurses mode is exited, but not by the ncurses handler of SIGTSTP.
+ */
+class OutputSink
+{
+	friend class Ncurses;
+	public:
+	explicit OutputSink(std::size_t, int = STDOUT_FILENO);
+
+	/// \cond NODOC
+	OutputSink(OutputSink const&) = delete;
+	OutputSink& operator=(OutputSink const&) = delete;
+
+	OutputSink(OutputSink&&) = delete;
+	OutputSink& operator=(OutputSink&&) = delete;
+	/// \endcond
+
+	~OutputSink();
+
+	std::size_t buffer_size() const;
+	int get_fd() const;
+	int line_count() const;
+	int column_count() const;
+
+	OutputSinkStats stats();
+	void reset_stats();
+
+	private:
+	int fd_;
+	int pipe_[2];
+	std::FILE* out_file_;
+	termios shell_modes_;
+	termios prog_modes_;
+	bool in_prog_mode_;
+
+	std::mutex mutex_;
+	std::unique_ptr<char[]> buffer_;
+	std::size_t capacity_;
+	std::size_t used_;
+	OutputSinkStats stats_;
+	std::size_t frame_syscalls_;
+	std::size_t frame_bytes_;
+	std::thread drain_thread_;
+
+	void drain_();
+	bool read_available_();
+	void flush_();
+	void end_frame_();
+	void suspend_();
+	void resume_();
+
+	int cbreak_(bool);
+	int raw_(bool);
+	int flush_on_interrupt_(bool);
+	int set_modes_(termios const&);
+
+	void close_();
+};
+
+} // namespace nccpp
+
+#include "OutputSink.ipp"
+
+#endif // Header guard
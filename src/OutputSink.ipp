@@ -0,0 +1,326 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+#ifndef NCURSESCPP_OUTPUTSINK_IPP_
+#define NCURSESCPP_OUTPUTSINK_IPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+
+#include "errors.hpp"
+
+namespace nccpp
+{
+
+/**
+ * \brief Create an output sink.
+ * 
+ * Use use_output_sink() to route the output of ncurses through a sink.
+ * 
+ * \param buffer_size Number of bytes buffered before a flush is forced in the middle of a frame.
+ * \param fd File descriptor of the tty.
+ * \exception errors::OutputSinkInit Thrown if the sink can't be created.
+ */
+inline OutputSink::OutputSink(std::size_t buffer_size, int fd)
+	: fd_{fd}, pipe_{-1, -1}, out_file_{nullptr}, shell_modes_{}, prog_modes_{}, in_prog_mode_{false}, mutex_{},
+	  buffer_{}, capacity_{buffer_size}, used_{0}, stats_{0, 0, 0, 0, 0, 0}, frame_syscalls_{0}, frame_bytes_{0},
+	  drain_thread_{}
+{
+	assert(buffer_size && "The buffer of the sink can't be empty");
+	if (!isatty(fd_) || tcgetattr(fd_, &shell_modes_) == -1 || pipe(pipe_) == -1 ||
+	    fcntl(pipe_[0], F_SETFL, fcntl(pipe_[0], F_GETFL) | O_NONBLOCK) == -1 ||
+	    !(out_file_ = fdopen(pipe_[1], "w")))
+	{
+		close_();
+		throw errors::OutputSinkInit{};
+	}
+#ifdef F_SETPIPE_SZ
+	// Let ncurses write a whole frame without waiting for the drain thread, failure is harmless
+	fcntl(pipe_[1], F_SETPIPE_SZ, static_cast<int>(std::min<std::size_t>(capacity_, 1 << 20)));
+#endif
+	// The modes newterm would set if it were bound to the tty
+	prog_modes_ = shell_modes_;
+	prog_modes_.c_lflag &= ~static_cast<tcflag_t>(ECHO | ECHONL);
+	prog_modes_.c_iflag &= ~static_cast<tcflag_t>(ICRNL | INLCR | IGNCR);
+	prog_modes_.c_oflag &= ~static_cast<tcflag_t>(ONLCR);
+	try
+	{
+		buffer_.reset(new char[capacity_]);
+		drain_thread_ = std::thread{[this]{drain_();}};
+	}
+	catch (...)
+	{
+		close_();
+		throw errors::OutputSinkInit{};
+	}
+}
+
+inline OutputSink::~OutputSink()
+{
+	// The drain thread sleeps until the pipe is readable, closing the write end wakes it up for good
+	std::fclose(out_file_);
+	out_file_ = nullptr;
+	pipe_[1] = -1;
+	drain_thread_.join();
+	suspend_();
+	close_();
+}
+
+/**
+ * \brief Get the size of the buffer.
+ * 
+ * \return The number of bytes buffered before a flush is forced in the middle of a frame.
+ */
+inline std::size_t OutputSink::buffer_size() const
+{
+	return capacity_;
+}
+
+/**
+ * \brief Get the file descriptor of the tty.
+ * 
+ * \return The file descriptor the frames are written to.
+ */
+inline int OutputSink::get_fd() const
+{
+	return fd_;
+}
+
+/**
+ * \brief Get the height of the tty.
+ * 
+ * \return The number of lines of the tty, or ERR if it can't be queried.
+ */
+inline int OutputSink::line_count() const
+{
+	winsize size{};
+	return ioctl(fd_, TIOCGWINSZ, &size) == -1 ? ERR : size.ws_row;
+}
+
+/**
+ * \brief Get the width of the tty.
+ * 
+ * \return The number of columns of the tty, or ERR if it can't be queried.
+ */
+inline int OutputSink::column_count() const
+{
+	winsize size{};
+	return ioctl(fd_, TIOCGWINSZ, &size) == -1 ? ERR : size.ws_col;
+}
+
+/**
+ * \brief Get the write counters.
+ * 
+ * \return A snapshot of the counters.
+ */
+inline OutputSinkStats OutputSink::stats()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	return stats_;
+}
+
+/**
+ * \brief Reset the write counters.
+ */
+inline void OutputSink::reset_stats()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	stats_ = OutputSinkStats{0, 0, 0, 0, 0, 0};
+	frame_syscalls_ = 0;
+	frame_bytes_ = 0;
+}
+
+inline void OutputSink::drain_()
+{
+	pollfd pfd{pipe_[0], POLLIN, 0};
+	auto timeout = -1;
+	for (;;)
+	{
+		auto ready = poll(&pfd, 1, timeout);
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (ready > 0 && !read_available_())
+		{
+			// The write end is closed, the sink is being destroyed
+			flush_();
+			return;
+		}
+		if (!ready)
+			// Output outside of a frame, wgetch refreshing its window for example
+			flush_();
+		// Only wait for the rest of such an output, sleep until ncurses writes again otherwise
+		timeout = used_ ? 10 : -1;
+	}
+}
+
+inline bool OutputSink::read_available_()
+{
+	ssize_t n{0};
+	while ((n = read(pipe_[0], buffer_.get() + used_, capacity_ - used_)) > 0 || (n == -1 && errno == EINTR))
+	{
+		if (n <= 0)
+			continue;
+		used_ += static_cast<std::size_t>(n);
+		if (used_ == capacity_)
+		{
+			++stats_.overflows;
+			flush_();
+		}
+	}
+	return n != 0;
+}
+
+inline void OutputSink::flush_()
+{
+	std::size_t done{0};
+	while (done != used_)
+	{
+		auto n = write(fd_, buffer_.get() + done, used_ - done);
+		if (n == -1 && errno != EINTR)
+			break; // The tty is gone, drop the output
+		if (n <= 0)
+			continue;
+		done += static_cast<std::size_t>(n);
+		++stats_.syscalls;
+		++frame_syscalls_;
+	}
+	stats_.bytes += done;
+	frame_bytes_ += done;
+	used_ = 0;
+}
+
+inline void OutputSink::end_frame_()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	// ncurses has returned, so every byte of the frame is already in the pipe
+	read_available_();
+	flush_();
+	++stats_.frames;
+	stats_.last_frame_syscalls = frame_syscalls_;
+	stats_.last_frame_bytes = frame_bytes_;
+	frame_syscalls_ = 0;
+	frame_bytes_ = 0;
+}
+
+inline void OutputSink::suspend_()
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		read_available_();
+		flush_();
+	}
+	if (in_prog_mode_)
+		tcsetattr(fd_, TCSADRAIN, &shell_modes_);
+	in_prog_mode_ = false;
+}
+
+inline void OutputSink::resume_()
+{
+	tcsetattr(fd_, TCSADRAIN, &prog_modes_);
+	in_prog_mode_ = true;
+}
+
+inline int OutputSink::cbreak_(bool on)
+{
+	auto modes = prog_modes_;
+	if (on)
+	{
+		modes.c_lflag &= ~static_cast<tcflag_t>(ICANON);
+		modes.c_iflag &= ~static_cast<tcflag_t>(ICRNL);
+		modes.c_lflag |= ISIG;
+		modes.c_cc[VMIN] = 1;
+		modes.c_cc[VTIME] = 0;
+	}
+	else
+	{
+		modes.c_lflag |= ICANON;
+		modes.c_iflag |= ICRNL;
+	}
+	return set_modes_(modes);
+}
+
+inline int OutputSink::raw_(bool on)
+{
+	auto modes = prog_modes_;
+	if (on)
+	{
+		modes.c_lflag &= ~static_cast<tcflag_t>(ICANON | ISIG | IEXTEN);
+		modes.c_iflag &= ~static_cast<tcflag_t>(IXON | BRKINT | PARMRK);
+		modes.c_cc[VMIN] = 1;
+		modes.c_cc[VTIME] = 0;
+	}
+	else
+	{
+		modes.c_lflag |= ISIG | ICANON | (shell_modes_.c_lflag & IEXTEN);
+		modes.c_iflag |= IXON | BRKINT | PARMRK;
+	}
+	return set_modes_(modes);
+}
+
+inline int OutputSink::flush_on_interrupt_(bool on)
+{
+	auto modes = prog_modes_;
+	if (on)
+		modes.c_lflag &= ~static_cast<tcflag_t>(NOFLSH);
+	else
+		modes.c_lflag |= NOFLSH;
+	return set_modes_(modes);
+}
+
+inline int OutputSink::set_modes_(termios const& modes)
+{
+	if (in_prog_mode_ && tcsetattr(fd_, TCSADRAIN, &modes) == -1)
+		return ERR;
+	prog_modes_ = modes;
+	return OK;
+}
+
+inline void OutputSink::close_()
+{
+	if (out_file_)
+		std::fclose(out_file_);
+	else if (pipe_[1] != -1)
+		::close(pipe_[1]);
+	if (pipe_[0] != -1)
+		::close(pipe_[0]);
+}
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -0,0 +1,139 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file Pad.hpp
+ * \brief Header file for the Pad class.
+ */
+
+#ifndef NCURSESCPP_PAD_HPP_
+#define NCURSESCPP_PAD_HPP_
+
+#include <cstddef>
+
+#ifndef NCURSESCPP_WINDOW_HPP_
+#define NCCPP_PAD_DELAYED_IMPL
+#endif
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/** \brief Handle to a subpad, returned by Pad::add_subpad. */
+using SubpadHandle = Handle<Pad>;
+
+/**
+ * \brief Class managing a ncurses pad.
+ * 
+ * A pad is a window which isn't bound to a screen position and can be larger than the terminal.
+ * The part of the pad displayed is selected by a viewport : a position in the pad, set with
+ * scroll_to(), and an area of the screen, set with set_screen_area().
+ * 
+ * Window::refresh() and Window::outrefresh() are overridden, so a pad refreshed through a Window
+ * reference is drawn in its viewport. Pads aren't coalesced by the frame scheduler.
+ */
+class Pad : public Window
+{
+	public:
+	Pad(int, int NCCPP_SITE_PARAM);
+
+	/// \cond NODOC
+	Pad(WINDOW* subpad, Window::Key /*dummy*/ NCCPP_SITE_DEF);
+
+	Pad(Pad const&) = delete;
+	Pad& operator=(Pad const&) = delete;
+
+	Pad(Pad&&) = default;
+	Pad& operator=(Pad&&) = default;
+	/// \endcond
+
+	~Pad() = default;
+
+	void assign(WINDOW*) override;
+	void destroy() override;
+
+	SubpadHandle add_subpad(int, int, int, int NCCPP_SITE_PARAM);
+	bool has_subpad(SubpadHandle) const;
+	Pad& get_subpad(SubpadHandle);
+	void delete_subpad(SubpadHandle);
+	void compact_subpads();
+
+	// Viewport
+
+	void set_screen_area(int, int, int, int);
+	void get_screen_area(int&, int&, int&, int&) const;
+	void scroll_to(int, int);
+	void scroll_by(int, int);
+	void get_position(int&, int&) const;
+
+	int refresh() override;
+	int refresh(int, int, int, int, int, int);
+	int outrefresh() override;
+	int outrefresh(int, int, int, int, int, int);
+
+	int echochar(chtype const);
+
+	private:
+	internal::SlotMap<Pad> subpads_;
+	int pos_y_;
+	int pos_x_;
+	int screen_y_;
+	int screen_x_;
+	int screen_lines_;
+	int screen_cols_;
+};
+
+} // namespace nccpp
+
+#ifndef NCCPP_PAD_NOIMPL
+#ifdef NCCPP_PAD_DELAYED_IMPL
+#include "Ncurses.hpp"
+#include "Subwindow.hpp"
+#include "Window.ipp"
+#undef NCCPP_PAD_DELAYED_IMPL
+#endif
+
+#include "Pad.ipp"
+#endif
+
+#endif // Header guard
@@ -0,0 +1,327 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+#ifndef NCURSESCPP_PAD_IPP_
+#define NCURSESCPP_PAD_IPP_
+
+#include <algorithm>
+#include <cassert>
+
+#include "errors.hpp"
+
+namespace nccpp
+{
+
+/**
+ * \brief Create a new ncurses pad.
+ * 
+ * Initially, the top left corner of the pad is displayed over the whole terminal.
+ * 
+ * \param nlines Height of the pad.
+ * \param ncols Width of the pad.
+ * \pre %Ncurses mode is on.
+ * \exception errors::WindowInit Thrown if the pad can't be created.
+ */
+inline Pad::Pad(int nlines, int ncols NCCPP_SITE_DEF)
+	: Window{internal::current_screen().newpad_(nlines, ncols, Key{}) NCCPP_SITE_FWD}, subpads_{}, pos_y_{0}, pos_x_{0},
+	  screen_y_{0}, screen_x_{0}, screen_lines_{LINES}, screen_cols_{COLS}
+{
+	if (!win_)
+		throw errors::WindowInit{};
+}
+
+/// \cond NODOC
+inline Pad::Pad(WINDOW* subpad, Window::Key /*dummy*/ NCCPP_SITE_DEF)
+	: Window{subpad NCCPP_SITE_FWD}, subpads_{}, pos_y_{0}, pos_x_{0}, screen_y_{0}, screen_x_{0},
+	  screen_lines_{LINES}, screen_cols_{COLS}
+{}
+/// \endcond
+
+/**
+ * \brief Take ownership of a new ncurses pad.
+ * 
+ * If there already is a managed pad, destroy it and its subpads.
+ * 
+ * \param new_pad The new pad.
+ * \pre %Ncurses mode is on.
+ * \pre new_pad is a pad.
+ */
+inline void Pad::assign(WINDOW* new_pad)
+{
+	subpads_.clear();
+	Window::assign(new_pad);
+}
+
+/**
+ * \brief Destroy the managed ncurses pad and its subpads, if present.
+ */
+inline void Pad::destroy()
+{
+	subpads_.clear();
+	Window::destroy();
+}
+
+/**
+ * \brief Create a new subpad.
+ * 
+ * The slot of a deleted subpad is reused if there is one.
+ * 
+ * \param lines,cols,beg_y,beg_x Values to pass on to subpad. The position is relative to the pad.
+ * \pre The Pad manages a ncurses pad.
+ * \pre The function parameters are valid subpad coordinates.
+ * \exception errors::WindowInit Thrown if the subpad can't be created.
+ * \return A handle to the subpad.
+ */
+inline SubpadHandle Pad::add_subpad(int lines, int cols, int beg_y, int beg_x NCCPP_SITE_DEF)
+{
+	assert(win_ && "Pad doesn't manage any object");
+	assert(beg_y >= 0 && beg_x >= 0 && getmaxy(win_) >= beg_y + lines && getmaxx(win_) >= beg_x + cols &&
+	       "Invalid subpad coordinates");
+	auto new_subpad = subpad(win_, lines, cols, beg_y, beg_x);
+	if (!new_subpad)
+		throw errors::WindowInit{};
+	try
+	{
+		return subpads_.emplace(new_subpad, Window::Key{} NCCPP_SITE_FWD);
+	}
+	catch (...)
+	{
+		delwin(new_subpad);
+		throw;
+	}
+}
+
+/**
+ * \brief Check whether a handle refers to an existing subpad of this pad.
+ * 
+ * \param handle Handle to check.
+ * \return false if the subpad has been deleted, true otherwise.
+ */
+inline bool Pad::has_subpad(SubpadHandle handle) const
+{
+	return subpads_.contains(handle);
+}
+
+/**
+ * \brief Get a subpad.
+ * 
+ * The reference stays valid until the subpad is deleted.
+ * 
+ * \param handle Handle to the subpad.
+ * \pre The Pad manages a ncurses pad.
+ * \pre *handle* refers to an existing subpad.
+ * \return A reference to the subpad.
+ */
+inline Pad& Pad::get_subpad(SubpadHandle handle)
+{
+	assert(win_ && "Pad doesn't manage any object");
+	assert(subpads_.contains(handle) && "Invalid subpad");
+	return subpads_.get(handle);
+}
+
+/**
+ * \brief Delete a subpad.
+ * 
+ * *handle* becomes stale, the other subpads aren't affected.
+ * 
+ * \param handle Handle to the subpad.
+ * \pre The Pad manages a ncurses pad.
+ * \pre *handle* refers to an existing subpad.
+ */
+inline void Pad::delete_subpad(SubpadHandle handle)
+{
+	assert(win_ && "Pad doesn't manage any object");
+	assert(subpads_.contains(handle) && "Invalid subpad");
+	subpads_.erase(handle);
+}
+
+/**
+ * \brief Release the memory held by the slots of deleted subpads, when possible.
+ * 
+ * \sa Window::compact_subwindows()
+ */
+inline void Pad::compact_subpads()
+{
+	subpads_.compact();
+}
+
+// Viewport
+
+/**
+ * \brief Set the area of the screen the pad is displayed in.
+ * 
+ * The position in the pad is clamped so that the viewport stays inside the pad.
+ * 
+ * \param y,x Position of the top left corner of the area on the screen.
+ * \param lines,cols Size of the area.
+ * \pre The Pad manages a ncurses pad.
+ */
+inline void Pad::set_screen_area(int y, int x, int lines, int cols)
+{
+	screen_y_ = y;
+	screen_x_ = x;
+	screen_lines_ = lines;
+	screen_cols_ = cols;
+	(this->scroll_to)(pos_y_, pos_x_);
+}
+
+/**
+ * \brief Get the area of the screen the pad is displayed in.
+ * 
+ * \param[out] y,x Position of the top left corner of the area on the screen.
+ * \param[out] lines,cols Size of the area.
+ */
+inline void Pad::get_screen_area(int& y, int& x, int& lines, int& cols) const
+{
+	y = screen_y_;
+	x = screen_x_;
+	lines = screen_lines_;
+	cols = screen_cols_;
+}
+
+/**
+ * \brief Set the position of the pad displayed at the top left corner of the screen area.
+ * 
+ * The position is clamped so that the viewport stays inside the pad.
+ * 
+ * \param y,x The position in the pad.
+ * \pre The Pad manages a ncurses pad.
+ */
+inline void Pad::scroll_to(int y, int x)
+{
+	assert(win_ && "Pad doesn't manage any object");
+	pos_y_ = std::max(0, std::min(y, getmaxy(win_) - screen_lines_));
+	pos_x_ = std::max(0, std::min(x, getmaxx(win_) - screen_cols_));
+}
+
+/**
+ * \brief Move the viewport relatively to its current position.
+ * 
+ * \param dy,dx Offset to add to the position in the pad.
+ * \pre The Pad manages a ncurses pad.
+ */
+inline void Pad::scroll_by(int dy, int dx)
+{
+	(this->scroll_to)(pos_y_ + dy, pos_x_ + dx);
+}
+
+/**
+ * \brief Get the position of the pad displayed at the top left corner of the screen area.
+ * 
+ * \param[out] y,x The position in the pad.
+ */
+inline void Pad::get_position(int& y, int& x) const
+{
+	y = pos_y_;
+	x = pos_x_;
+}
+
+/**
+ * \brief Call prefresh for this pad with the current viewport.
+ * 
+ * \pre The Pad manages a ncurses pad.
+ * \return The result of the operation.
+ */
+inline int Pad::refresh()
+{
+	return (this->refresh)(pos_y_, pos_x_, screen_y_, screen_x_,
+	                       screen_y_ + screen_lines_ - 1, screen_x_ + screen_cols_ - 1);
+}
+
+/**
+ * \brief Call prefresh for this pad.
+ * 
+ * \param pminrow,pmincol,sminrow,smincol,smaxrow,smaxcol Values to pass on to prefresh.
+ * \pre The Pad manages a ncurses pad.
+ * \return The result of the operation.
+ */
+inline int Pad::refresh(int pminrow, int pmincol, int sminrow, int smincol, int smaxrow, int smaxcol)
+{
+	assert(win_ && "Pad doesn't manage any object");
+	NCCPP_RECORD(*this, refreshes, 1);
+	NCCPP_TIME_SCOPE(internal::render_stats_of(*this).refresh_time);
+	auto ret = prefresh(win_, pminrow, pmincol, sminrow, smincol, smaxrow, smaxcol);
+	(this->get_owning_screen)().end_frame_(Key{});
+	return ret;
+}
+
+/**
+ * \brief Call pnoutrefresh for this pad with the current viewport.
+ * 
+ * \pre The Pad manages a ncurses pad.
+ * \return The result of the operation.
+ */
+inline int Pad::outrefresh()
+{
+	return (this->outrefresh)(pos_y_, pos_x_, screen_y_, screen_x_,
+	                          screen_y_ + screen_lines_ - 1, screen_x_ + screen_cols_ - 1);
+}
+
+/**
+ * \brief Call pnoutrefresh for this pad.
+ * 
+ * \param pminrow,pmincol,sminrow,smincol,smaxrow,smaxcol Values to pass on to pnoutrefresh.
+ * \pre The Pad manages a ncurses pad.
+ * \return The result of the operation.
+ */
+inline int Pad::outrefresh(int pminrow, int pmincol, int sminrow, int smincol, int smaxrow, int smaxcol)
+{
+	assert(win_ && "Pad doesn't manage any object");
+	NCCPP_RECORD(*this, outrefreshes, 1);
+	return pnoutrefresh(win_, pminrow, pmincol, sminrow, smincol, smaxrow, smaxcol);
+}
+
+/**
+ * \brief Call pechochar for this pad.
+ * 
+ * The pad is refreshed with the viewport of its last refresh.
+ * 
+ * \param ch Value to pass on to pechochar.
+ * \pre The Pad manages a ncurses pad.
+ * \return The result of the operation.
+ */
+inline int Pad::echochar(chtype const ch)
+{
+	assert(win_ && "Pad doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addch, 1);
+	auto ret = pechochar(win_, ch);
+	(this->get_owning_screen)().end_frame_(Key{});
+	return ret;
+}
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -0,0 +1,126 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file PagedPad.hpp
+ * \brief Header file for the PagedPad class.
+ */
+
+#ifndef NCURSESCPP_PAGEDPAD_HPP_
+#define NCURSESCPP_PAGEDPAD_HPP_
+
+#include <cstddef>
+#include <functional>
+
+#include "Pad.hpp"
+
+namespace nccpp
+{
+
+/**
+ * \brief Scrollable view over a very large number of rows, backed by a small pad.
+ * 
+ * Only the rows around the viewport are materialised in the pad. When the viewport leaves them,
+ * the pad is scrolled and only the rows which appeared are rendered, by calling the row renderer.
+ * The pad height is the page size given to the constructor, independently of the row count.
+ */
+class PagedPad
+{
+	public:
+	/**
+	 * \brief Function rendering a row.
+	 * 
+	 * Called with the pad, the pad line to draw into, which is already cleared, and the index
+	 * of the row to render. The renderer must only draw on that line.
+	 */
+	using RowRenderer = std::function<void(Pad&, int, std::size_t)>;
+
+	PagedPad(std::size_t, int, int, RowRenderer NCCPP_SITE_PARAM);
+
+	/// \cond NODOC
+	PagedPad(PagedPad const&) = delete;
+	PagedPad& operator=(PagedPad const&) = delete;
+
+	PagedPad(PagedPad&&) = default;
+	PagedPad& operator=(PagedPad&&) = default;
+	/// \endcond
+
+	~PagedPad() = default;
+
+	Pad& get_pad();
+
+	void set_row_count(std::size_t);
+	std::size_t get_row_count() const;
+
+	void set_screen_area(int, int, int, int);
+	void scroll_to(std::size_t, int);
+	void scroll_by(long, int);
+	std::size_t get_top_row() const;
+	int get_left_column() const;
+
+	void invalidate();
+	void invalidate_rows(std::size_t, std::size_t);
+
+	int refresh();
+	int outrefresh();
+
+	std::size_t rendered_rows() const;
+
+	private:
+	Pad pad_;
+	RowRenderer render_;
+	std::size_t rows_;
+	std::size_t base_;
+	std::size_t top_;
+	int left_;
+	int page_lines_;
+	int screen_y_;
+	int screen_x_;
+	int screen_lines_;
+	int screen_cols_;
+	bool valid_;
+	std::size_t rendered_;
+
+	int view_lines_() const;
+	void materialize_();
+	void render_lines_(int, int);
+};
+
+} // namespace nccpp
+
+#include "PagedPad.ipp"
+
+#endif // Header guard
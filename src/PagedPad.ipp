@@ -0,0 +1,294 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+#ifndef NCURSESCPP_PAGEDPAD_IPP_
+#define NCURSESCPP_PAGEDPAD_IPP_
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace nccpp
+{
+
+/**
+ * \brief Create a paged pad.
+ * 
+ * The view is displayed over the whole terminal until set_screen_area() is called.
+ * 
+ * \param rows Number of rows of the content.
+ * \param cols Width of the content.
+ * \param page_lines Number of rows materialised in the pad. It should be a few times the height
+ * of the viewport, so that small scrolls don't require rendering.
+ * \param render Function rendering a row in the pad.
+ * \pre %Ncurses mode is on.
+ * \exception errors::WindowInit Thrown if the pad can't be created.
+ */
+inline PagedPad::PagedPad(std::size_t rows, int cols, int page_lines, RowRenderer render NCCPP_SITE_DEF)
+	: pad_{page_lines, cols NCCPP_SITE_FWD}, render_{std::move(render)}, rows_{rows}, base_{0}, top_{0}, left_{0},
+	  page_lines_{page_lines}, screen_y_{0}, screen_x_{0}, screen_lines_{LINES}, screen_cols_{COLS},
+	  valid_{false}, rendered_{0}
+{}
+
+/**
+ * \brief Get the underlying pad.
+ * 
+ * \return The pad holding the materialised rows.
+ */
+inline Pad& PagedPad::get_pad()
+{
+	return pad_;
+}
+
+/**
+ * \brief Change the number of rows of the content.
+ * 
+ * Materialised rows which appeared or disappeared are rendered again.
+ * 
+ * \param rows The new number of rows.
+ */
+inline void PagedPad::set_row_count(std::size_t rows)
+{
+	auto first = std::min(rows, rows_);
+	auto count = std::max(rows, rows_) - first;
+	rows_ = rows;
+	(this->invalidate_rows)(first, count);
+	(this->scroll_to)(top_, left_);
+}
+
+/**
+ * \brief Get the number of rows of the content.
+ * 
+ * \return The number of rows.
+ */
+inline std::size_t PagedPad::get_row_count() const
+{
+	return rows_;
+}
+
+/**
+ * \brief Set the area of the screen the view is displayed in.
+ * 
+ * Lines of the area beyond the page size are not drawn.
+ * 
+ * \param y,x Position of the top left corner of the area on the screen.
+ * \param lines,cols Size of the area.
+ */
+inline void PagedPad::set_screen_area(int y, int x, int lines, int cols)
+{
+	screen_y_ = y;
+	screen_x_ = x;
+	screen_lines_ = lines;
+	screen_cols_ = cols;
+	(this->scroll_to)(top_, left_);
+}
+
+/**
+ * \brief Set the row and column displayed at the top left corner of the screen area.
+ * 
+ * The position is clamped so that the viewport stays inside the content.
+ * 
+ * \param row The index of the top row.
+ * \param col The index of the leftmost column.
+ */
+inline void PagedPad::scroll_to(std::size_t row, int col)
+{
+	auto view = static_cast<std::size_t>((this->view_lines_)());
+	top_ = std::min(row, rows_ > view ? rows_ - view : 0);
+	left_ = std::max(0, std::min(col, getmaxx(pad_.get_handle()) - screen_cols_));
+}
+
+/**
+ * \brief Move the viewport relatively to its current position.
+ * 
+ * \param dy Number of rows to scroll, negative values scroll up.
+ * \param dx Number of columns to scroll, negative values scroll left.
+ */
+inline void PagedPad::scroll_by(long dy, int dx)
+{
+	auto up = static_cast<std::size_t>(dy < 0 ? -dy : 0);
+	auto row = top_ < up ? 0 : top_ - up + static_cast<std::size_t>(dy > 0 ? dy : 0);
+	(this->scroll_to)(row, left_ + dx);
+}
+
+/**
+ * \brief Get the row displayed at the top of the screen area.
+ * 
+ * \return The index of the top row.
+ */
+inline std::size_t PagedPad::get_top_row() const
+{
+	return top_;
+}
+
+/**
+ * \brief Get the column displayed at the left of the screen area.
+ * 
+ * \return The index of the leftmost column.
+ */
+inline int PagedPad::get_left_column() const
+{
+	return left_;
+}
+
+/**
+ * \brief Render all the materialised rows again at the next refresh.
+ */
+inline void PagedPad::invalidate()
+{
+	valid_ = false;
+}
+
+/**
+ * \brief Render rows again.
+ * 
+ * Rows which are currently materialised are rendered immediately, the others will be rendered
+ * when they are materialised.
+ * 
+ * \param first The index of the first row.
+ * \param count The number of rows.
+ */
+inline void PagedPad::invalidate_rows(std::size_t first, std::size_t count)
+{
+	if (!valid_)
+		return;
+	auto begin = std::max(first, base_);
+	auto end = std::min(first + count, base_ + static_cast<std::size_t>(page_lines_));
+	if (begin < end)
+		(this->render_lines_)(static_cast<int>(begin - base_), static_cast<int>(end - begin));
+}
+
+/**
+ * \brief Materialise the rows of the viewport and call prefresh for the pad.
+ * 
+ * \return The result of the operation.
+ */
+inline int PagedPad::refresh()
+{
+	(this->materialize_)();
+	int y{static_cast<int>(top_ - base_)};
+	return pad_.refresh(y, left_, screen_y_, screen_x_, screen_y_ + (this->view_lines_)() - 1,
+	                    screen_x_ + screen_cols_ - 1);
+}
+
+/**
+ * \brief Materialise the rows of the viewport and call pnoutrefresh for the pad.
+ * 
+ * \return The result of the operation.
+ */
+inline int PagedPad::outrefresh()
+{
+	(this->materialize_)();
+	int y{static_cast<int>(top_ - base_)};
+	return pad_.outrefresh(y, left_, screen_y_, screen_x_, screen_y_ + (this->view_lines_)() - 1,
+	                       screen_x_ + screen_cols_ - 1);
+}
+
+/**
+ * \brief Get the number of rows rendered since the creation of the view.
+ * 
+ * \return The number of calls to the row renderer.
+ */
+inline std::size_t PagedPad::rendered_rows() const
+{
+	return rendered_;
+}
+
+/// \cond NODOC
+inline int PagedPad::view_lines_() const
+{
+	return std::min(screen_lines_, page_lines_);
+}
+
+inline void PagedPad::materialize_()
+{
+	auto page = static_cast<std::size_t>(page_lines_);
+	auto view = static_cast<std::size_t>((this->view_lines_)());
+	if (valid_ && top_ >= base_ && top_ + view <= base_ + page)
+		return;
+
+	// Center the viewport in the new page, without going past the end of the content.
+	auto margin = (page - view) / 2;
+	auto base = top_ < margin ? 0 : top_ - margin;
+	base = std::min(base, rows_ > page ? rows_ - page : 0);
+
+	WINDOW* pad{pad_.get_handle()};
+	if (valid_ && base > base_ && base - base_ < page)
+	{
+		auto shift = static_cast<int>(base - base_);
+		scrollok(pad, TRUE);
+		wscrl(pad, shift);
+		scrollok(pad, FALSE);
+		base_ = base;
+		(this->render_lines_)(page_lines_ - shift, shift);
+	}
+	else if (valid_ && base < base_ && base_ - base < page)
+	{
+		auto shift = static_cast<int>(base_ - base);
+		scrollok(pad, TRUE);
+		wscrl(pad, -shift);
+		scrollok(pad, FALSE);
+		base_ = base;
+		(this->render_lines_)(0, shift);
+	}
+	else
+	{
+		base_ = base;
+		(this->render_lines_)(0, page_lines_);
+	}
+	valid_ = true;
+}
+
+inline void PagedPad::render_lines_(int first, int count)
+{
+	WINDOW* pad{pad_.get_handle()};
+	for (int y{first}; y != first + count; ++y)
+	{
+		wmove(pad, y, 0);
+		wclrtoeol(pad);
+		auto row = base_ + static_cast<std::size_t>(y);
+		if (row < rows_)
+		{
+			render_(pad_, y, row);
+			++rendered_;
+		}
+	}
+}
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
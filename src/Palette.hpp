@@ -0,0 +1,186 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+/**
+ * \file Palette.hpp
+ * \brief Header file for the Palette class.
+ */
+
+#ifndef NCURSESCPP_PALETTE_HPP_
+#define NCURSESCPP_PALETTE_HPP_
+
+#include <cstddef>
+#include <type_traits>
+
+#include "Ncurses.hpp"
+#include "Color.hpp"
+#include "Style.hpp"
+
+namespace nccpp
+{
+
+/**
+ * \brief Color pair of a Palette.
+ * 
+ * Palette entries are named by deriving from this class:
+ * \code
+ * struct Warning : nccpp::PaletteEntry<nccpp::colors::yellow, nccpp::colors::black> {};
+ * \endcode
+ * 
+ * \tparam Foreground,Background The colors of the pair. -1 is the default terminal color.
+ */
+template <short Foreground, short Background>
+struct PaletteEntry
+{
+	static short constexpr foreground{Foreground}; ///< Foreground color.
+	static short constexpr background{Background}; ///< Background color.
+};
+
+/// \cond NODOC
+namespace internal
+{
+
+template <typename Entry, typename... Entries>
+struct PaletteIndex
+{
+	static_assert(sizeof(Entry) == 0, "Entry isn't part of the palette");
+};
+
+template <typename Entry, typename... Entries>
+struct PaletteIndex<Entry, Entry, Entries...> : std::integral_constant<std::size_t, 0>
+{};
+
+template <typename Entry, typename First, typename... Entries>
+struct PaletteIndex<Entry, First, Entries...>
+	: std::integral_constant<std::size_t, 1 + PaletteIndex<Entry, Entries...>::value>
+{};
+
+} // namespace internal
+/// \endcond
+
+/**
+ * \brief Fixed set of color pairs resolved at compile time.
+ * 
+ * The pairs of the palette are registered in one batch by Screen::start_color<P>(). They occupy
+ * the first pair numbers, in declaration order, so the attribute of an entry is a constant
+ * expression and drawing with it never goes through Screen::color_to_pair_number().
+ * \code
+ * using Theme = nccpp::Palette<Normal, Warning, Error>;
+ * nccpp::ncurses().start_color<Theme>();
+ * win.attron(Theme::attr<Warning>());
+ * \endcode
+ * 
+ * \tparam Entries The PaletteEntry types of the palette.
+ */
+template <typename... Entries>
+class Palette
+{
+	static_assert(sizeof...(Entries) > 0, "A palette needs at least one entry");
+
+	public:
+	static std::size_t constexpr size{sizeof...(Entries)}; ///< Number of pairs in the palette.
+
+	/**
+	 * \brief Get the pair number of an entry.
+	 * 
+	 * \tparam Entry The entry.
+	 * \pre The palette has been registered with Screen::start_color<P>().
+	 * \return The pair number of the entry.
+	 */
+	template <typename Entry>
+	static constexpr short pair_number()
+	{
+		return static_cast<short>(internal::PaletteIndex<Entry, Entries...>::value + 1);
+	}
+
+	/**
+	 * \brief Get the attribute of an entry.
+	 * 
+	 * \tparam Entry The entry.
+	 * \pre The palette has been registered with Screen::start_color<P>().
+	 * \return The attribute associated with the entry.
+	 */
+	template <typename Entry>
+	static constexpr attr_t attr()
+	{
+		// COLOR_PAIR is a function when NCURSES_NOMACROS is defined
+		return static_cast<attr_t>(NCURSES_BITS(pair_number<Entry>(), 0) & A_COLOR);
+	}
+
+	/**
+	 * \brief Get the style of an entry.
+	 * 
+	 * \tparam Entry The entry.
+	 * \param a The attributes of the style.
+	 * \pre The palette has been registered with Screen::start_color<P>().
+	 * \return The style combining the attributes with the pair of the entry.
+	 */
+	template <typename Entry>
+	static constexpr Style style(attr_t a = A_NORMAL)
+	{
+		return Style{a, pair_number<Entry>()};
+	}
+
+	/**
+	 * \brief Get the colors of the palette.
+	 * 
+	 * \return An array of Palette::size colors, in declaration order.
+	 */
+	static Color const* colors()
+	{
+		return colors_;
+	}
+
+	private:
+	static Color constexpr colors_[sizeof...(Entries)]{Color{Entries::foreground, Entries::background}...};
+};
+
+/// \cond NODOC
+template <typename... Entries>
+Color constexpr Palette<Entries...>::colors_[sizeof...(Entries)];
+
+template <typename... Entries>
+std::size_t constexpr Palette<Entries...>::size;
+
+template <short Foreground, short Background>
+short constexpr PaletteEntry<Foreground, Background>::foreground;
+
+template <short Foreground, short Background>
+short constexpr PaletteEntry<Foreground, Background>::background;
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -0,0 +1,319 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+/**
+ * \file Screen.hpp
+ * \brief Header file for the Screen class.
+ */
+
+#ifndef NCURSESCPP_SCREEN_HPP_
+#define NCURSESCPP_SCREEN_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+#include "Color.hpp"
+
+#ifndef NCCPP_FRAMESCHEDULER_NOIMPL
+#define NCCPP_FRAMESCHEDULER_NOIMPL
+#include "FrameScheduler.hpp"
+#undef NCCPP_FRAMESCHEDULER_NOIMPL
+#else
+#include "FrameScheduler.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Counters describing the behaviour of the color pair cache.
+ */
+struct ColorCacheStats
+{
+	std::size_t hits;      ///< Lookups resolved to an already registered pair.
+	std::size_t misses;    ///< Lookups that had to register a new pair.
+	std::size_t evictions; ///< Pairs reused for another color while recycling.
+};
+
+/**
+ * \brief A terminal driven by ncurses.
+ * 
+ * Each screen has its own stdscr, which the Screen object wraps, its own color pairs and its own frame scheduler.
+ * The Ncurses singleton is the screen of the process' terminal; more screens can be created on other terminals,
+ * ptys for example, so that one process drives several of them.
+ * 
+ * Like ncurses, the library works on the current screen: windows are created, refreshed and destroyed on the
+ * screen which is current at that time. Switching screens with make_current() only swaps a few pointers.
+ * The size, color and terminal mode functions of a Screen always act on that screen: they make it current for
+ * the duration of the call when it isn't.
+ */
+class Screen : public Window
+{
+	friend class ScreenPool;
+	public:
+	Screen(std::FILE*, std::FILE*, char const* = nullptr);
+
+	/// \cond NODOC
+	Screen(Screen const&) = delete;
+	Screen& operator=(Screen const&) = delete;
+
+	Screen(Screen&&) = delete;
+	Screen& operator=(Screen&&) = delete;
+	/// \endcond
+
+	~Screen();
+
+	void make_current();
+	bool is_current() const;
+	SCREEN* get_screen();
+	int get_input_fd();
+
+	virtual void exit_ncurses_mode();
+	virtual void resume_ncurses_mode();
+
+	// Input options
+
+	virtual int cbreak(bool);
+	int echo(bool);
+	virtual int halfdelay(int);
+	virtual int intrflush(bool);
+	int meta(bool);
+	virtual int raw(bool);
+	virtual void qiflush(bool);
+	int typeahead(int);
+
+	// Output options
+
+	int clearok(bool, bool = false);
+	int idlok(bool);
+	void idcok(bool);
+	void immedok(bool);
+	int leaveok(bool);
+	int scrollok(bool);
+	int nl(bool);
+
+	// Misc
+
+	int doupdate();
+	int line_count();
+	int column_count();
+	int resizeterm(int, int);
+	bool is_term_resized(int, int);
+	virtual int update_terminal_size();
+
+	FrameScheduler& get_frame_scheduler();
+
+#ifdef NCCPP_WINDOW_REGISTRY
+	// Debugging
+
+	std::size_t live_window_count() const;
+	void dump_live_windows(std::FILE* = stderr) const;
+#endif
+
+#ifdef NCCPP_INSTRUMENTATION
+	// Instrumentation
+
+	RenderStats render_stats() const;
+	void reset_render_stats();
+#endif
+
+	// Window
+
+	/// \cond NODOC
+	WINDOW* newwin_(int, int, int, int, Window::Key);
+	WINDOW* newpad_(int, int, Window::Key);
+	virtual void end_frame_(Window::Key);
+#ifndef NDEBUG
+	bool owns_thread_() const;
+#endif
+#ifdef NCCPP_WINDOW_REGISTRY
+	void register_window_(Window&, Window::Key);
+	void unregister_window_(Window&, Window::Key);
+#endif
+	/// \endcond
+
+	// Color
+
+	void start_color();
+	template <typename P>
+	void start_color();
+	int use_default_colors();
+
+	short color_to_pair_number(Color const&);
+	attr_t color_to_attr(Color const&);
+	Style make_style(attr_t, Color const&);
+	Color pair_number_to_color(short);
+	Color attr_to_color(attr_t);
+
+	int init_color(short, short, short, short);
+
+	void set_color_recycling(bool);
+	ColorCacheStats color_cache_stats() const;
+	void reset_color_cache_stats();
+
+	protected:
+	Screen(WINDOW*, SCREEN*);
+
+	SCREEN* screen_;
+	int input_fd_;
+	int output_fd_;
+#ifdef NCCPP_WINDOW_REGISTRY
+	Window* windows_head_;
+	Window* windows_tail_;
+	std::size_t window_count_;
+#endif
+#ifndef NDEBUG
+	bool is_exit_;
+	// Thread the screen is bound to by a ScreenPool, any thread if default constructed
+	std::thread::id owner_;
+#endif
+
+	void end_screen_();
+	int resize_to_(int, int);
+
+	private:
+	/// \cond NODOC
+	struct PairLink
+	{
+		short prev;
+		short next;
+	};
+	/// \endcond
+
+	explicit Screen(SCREEN*);
+
+	FrameScheduler scheduler_;
+	std::vector<Color> registered_colors_;
+	std::unordered_map<Color, short> color_index_;
+	std::vector<PairLink> pair_links_;
+	short pinned_pairs_;
+	short lru_head_;
+	short lru_tail_;
+	bool recycle_colors_;
+	ColorCacheStats color_stats_;
+#ifdef NCCPP_INSTRUMENTATION
+	std::size_t doupdates_;
+	std::chrono::nanoseconds doupdate_time_;
+#endif
+	bool colors_initialized_;
+	bool default_colors_;
+
+	void register_palette_(Color const*, std::size_t);
+	short register_pair_(Color const&);
+	short recycle_pair_(Color const&);
+	void link_pair_(short);
+	void unlink_pair_(short);
+
+	void assign(WINDOW*) override;
+	void destroy() override;
+};
+
+/// \cond NODOC
+namespace internal
+{
+
+// Screen made current by the last call to Screen::make_current, nullptr before the first one
+inline Screen*& current_screen_ptr()
+{
+	static Screen* screen{nullptr};
+	return screen;
+}
+
+// Screens ended by Screen::end_screen_ and not deleted yet
+// delscreen clears the standard windows of every screen, so the screens are deleted with the last one
+struct EndedScreens
+{
+	std::vector<SCREEN*> screens;
+	std::size_t live_count;
+};
+
+// Used by every Screen constructor, so that it outlives the static Ncurses object
+inline EndedScreens& ended_screens()
+{
+	static EndedScreens screens{{}, 0};
+	return screens;
+}
+
+// Make a screen current for the lifetime of the object, then restore the previous one
+class ScreenScope
+{
+	public:
+	explicit ScreenScope(Screen& screen)
+		: previous_{current_screen_ptr()}
+	{
+		if (previous_ != &screen)
+			screen.make_current();
+	}
+
+	ScreenScope(ScreenScope const&) = delete;
+	ScreenScope& operator=(ScreenScope const&) = delete;
+
+	~ScreenScope()
+	{
+		if (current_screen_ptr() == previous_)
+			return;
+		if (previous_)
+			previous_->make_current();
+		else
+			current_screen_ptr() = nullptr;
+	}
+
+	private:
+	Screen* previous_;
+};
+
+} // namespace internal
+/// \endcond
+
+} // namespace nccpp
+
+#ifndef NCCPP_SCREEN_NOIMPL
+#include "Ncurses.hpp"
+
+#include "Screen.ipp"
+#endif
+
+#endif // Header guard
@@ -0,0 +1,1039 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+#ifndef NCURSESCPP_SCREEN_IPP_
+#define NCURSESCPP_SCREEN_IPP_
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include <sys/ioctl.h>
+
+#include "errors.hpp"
+
+namespace nccpp
+{
+
+/**
+ * \brief Create a screen on a terminal, with newterm.
+ * 
+ * The new screen becomes the current one.
+ * 
+ * \param out The terminal output.
+ * \param in The terminal input.
+ * \param type Terminal type, as in the TERM environment variable. If nullptr, TERM is used.
+ * \exception errors::ScreenInit Thrown if the screen can't be created.
+ */
+inline Screen::Screen(std::FILE* out, std::FILE* in, char const* type)
+	: Screen{newterm(type, out, in)}
+{
+	if (!win_)
+		throw errors::ScreenInit{};
+	input_fd_ = fileno(in);
+	output_fd_ = fileno(out);
+}
+
+inline Screen::Screen(SCREEN* screen)
+	: Screen{screen ? stdscr : nullptr, screen}
+{}
+
+inline Screen::Screen(WINDOW* win, SCREEN* screen)
+	: Window{win}, screen_{screen}, input_fd_{-1}, output_fd_{-1},
+#ifdef NCCPP_WINDOW_REGISTRY
+	  windows_head_{nullptr}, windows_tail_{nullptr}, window_count_{0},
+#endif
+#ifndef NDEBUG
+	  is_exit_{false}, owner_{},
+#endif
+	  scheduler_{*this}, registered_colors_{}, color_index_{}, pair_links_{}, pinned_pairs_{0}, lru_head_{0},
+	  lru_tail_{0}, recycle_colors_{false}, color_stats_{0, 0, 0},
+#ifdef NCCPP_INSTRUMENTATION
+	  doupdates_{0}, doupdate_time_{0},
+#endif
+	  colors_initialized_{false}, default_colors_{false}
+{
+	owning_screen_ = this;
+	if (win_)
+	{
+		internal::current_screen_ptr() = this;
+		++internal::ended_screens().live_count;
+	}
+}
+
+/**
+ * \brief Destroy the screen, with endwin and delscreen.
+ * 
+ * Every window of the screen must have been destroyed before.
+ * delscreen clears the standard windows of every other screen, so it's delayed until the last screen
+ * is destroyed : the memory of an ended SCREEN is only freed when no screen is left, and a process
+ * which keeps creating and destroying screens grows until then.
+ * If the screen is current, no screen is current afterwards and the next window created makes the
+ * Ncurses singleton current.
+ */
+inline Screen::~Screen()
+{
+	if (screen_)
+		end_screen_();
+	win_ = nullptr;
+	if (is_current())
+		internal::current_screen_ptr() = nullptr;
+}
+
+/**
+ * \brief Make this screen the current one, with set_term.
+ */
+inline void Screen::make_current()
+{
+	assert(owns_thread_() && "Screen is used from the wrong thread");
+	if (screen_)
+		set_term(screen_);
+	internal::current_screen_ptr() = this;
+}
+
+/**
+ * \brief Check if this screen is the current one.
+ * 
+ * \return true if the screen is current, false otherwise.
+ */
+inline bool Screen::is_current() const
+{
+	return internal::current_screen_ptr() == this;
+}
+
+/**
+ * \brief Get the ncurses screen.
+ * 
+ * \return The screen returned by newterm.
+ */
+inline SCREEN* Screen::get_screen()
+{
+	return screen_;
+}
+
+/**
+ * \brief Get the file descriptor the screen reads input from.
+ * 
+ * Waiting for this descriptor to be readable, with poll for example, avoids blocking in getch.
+ * Note that ncurses buffers input, so getch may still have keys to return when it isn't readable.
+ * 
+ * \return The file descriptor of the terminal input.
+ */
+inline int Screen::get_input_fd()
+{
+	return input_fd_;
+}
+
+#ifndef NDEBUG
+inline bool Screen::owns_thread_() const
+{
+	return owner_ == std::thread::id{} || owner_ == std::this_thread::get_id();
+}
+#endif
+
+/**
+ * \brief Exit ncurses mode and restore normal terminal properties.
+ * 
+ * Like the option functions, this function acts on this screen even if it isn't current.
+ * 
+ * \pre %Ncurses mode is on.
+ */
+inline void Screen::exit_ncurses_mode()
+{
+	assert(!is_exit_ && "Ncurses mode is already off");
+#ifndef NDEBUG
+	for (auto elem = windows_head_; elem; elem = elem->registry_.next)
+		elem->invalidate_for_exit_(Window::Key{});
+	invalidate_for_exit_(Key{});
+	is_exit_ = true;
+#endif
+	internal::ScreenScope scope{*this};
+	endwin();
+}
+
+/**
+ * \brief Restore ncurses mode after a call to exit_ncurses_mode().
+ * 
+ * \pre %Ncurses mode is off.
+ */
+inline void Screen::resume_ncurses_mode()
+{
+	assert(is_exit_ && "Ncurses mode is already on");
+#ifndef NDEBUG
+	for (auto elem = windows_head_; elem; elem = elem->registry_.next)
+		elem->validate_for_resume_(Window::Key{});
+	validate_for_resume_(Key{});
+	is_exit_ = false;
+#endif
+	internal::ScreenScope scope{*this};
+	doupdate();
+}
+
+// Input options
+
+/**
+ * \brief Change cbreak mode.
+ * 
+ * \param on If true, call cbreak. Else, call nocbreak.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::cbreak(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return on ? ::cbreak() : nocbreak();
+}
+
+/**
+ * \brief Change echo mode.
+ * 
+ * \param on If true, call echo. Else, call noecho.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::echo(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return on ? ::echo() : noecho();
+}
+
+/**
+ * \brief Call halfdelay.
+ * 
+ * \param delay Value to pass on to halfdelay.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::halfdelay(int delay)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::halfdelay(delay);
+}
+
+/**
+ * \brief Call intrflush.
+ * 
+ * \param on Value to pass on to intrflush.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::intrflush(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::intrflush(win_, on);
+}
+
+/**
+ * \brief Call meta.
+ * 
+ * \param on Value to pass on to meta.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::meta(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::meta(win_, on);
+}
+
+/**
+ * \brief Change raw mode.
+ * 
+ * \param on If true, call raw. Else, call noraw.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::raw(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return on ? ::raw() : noraw();
+}
+
+/**
+ * \brief Change qiflush mode.
+ * 
+ * \param on If true, call qiflush. Else, call noquiflush.
+ * \pre %Ncurses mode is on.
+ */
+inline void Screen::qiflush(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	on ? ::qiflush() : noqiflush();
+}
+
+/**
+ * \brief Call typeahead.
+ * 
+ * \param fd Value to pass on to typeahead.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::typeahead(int fd)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::typeahead(fd);
+}
+
+// Output options
+
+/**
+ * \brief Call clearok.
+ * 
+ * \param on Value to pass on to clearok.
+ * \param use_cs If true, call clearok with *curscr* as argument.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::clearok(bool on, bool use_cs)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::clearok(use_cs ? curscr : win_, on);
+}
+
+/**
+ * \brief Call idlok.
+ * 
+ * \param on Value to pass on to idlok.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::idlok(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::idlok(win_, on);
+}
+
+/**
+ * \brief Call idcok.
+ * 
+ * \param on Value to pass on to idcok.
+ * \pre %Ncurses mode is on.
+ */
+inline void Screen::idcok(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	::idcok(win_, on);
+}
+
+/**
+ * \brief Call immedok.
+ * 
+ * \param on Value to pass on to immedok.
+ * \pre %Ncurses mode is on.
+ */
+inline void Screen::immedok(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	::immedok(win_, on);
+}
+
+/**
+ * \brief Call leaveok.
+ * 
+ * \param on Value to pass on to leaveok.
+ * \pre %Ncurses mode is on.
+ */
+inline int Screen::leaveok(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::leaveok(win_, on);
+}
+
+/**
+ * \brief Call scrollok.
+ * 
+ * \param on Value to pass on to scrollok.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::scrollok(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::scrollok(win_, on);
+}
+
+/**
+ * \brief Change nl mode.
+ * 
+ * \param on If true, call nl. Else, call nonl.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::nl(bool on)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return on ? ::nl() : nonl();
+}
+
+// Misc
+
+/**
+ * \brief Call doupdate.
+ * 
+ * This screen is updated even if it isn't current.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::doupdate()
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	assert(owns_thread_() && "Screen is used from the wrong thread");
+	internal::ScreenScope scope{*this};
+#ifdef NCCPP_INSTRUMENTATION
+	++doupdates_;
+#endif
+	NCCPP_TIME_SCOPE(doupdate_time_);
+	auto ret = ::doupdate();
+	end_frame_(Key{});
+	return ret;
+}
+
+/**
+ * \brief Get the height of the terminal.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return The number of lines of the terminal.
+ */
+inline int Screen::line_count()
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	return getmaxy(win_);
+}
+
+/**
+ * \brief Get the width of the terminal.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return The number of columns of the terminal.
+ */
+inline int Screen::column_count()
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	return getmaxx(win_);
+}
+
+/**
+ * \brief Call resizeterm.
+ * 
+ * The standard windows are resized, as well as the windows which reach the edge of the screen, and
+ * KEY_RESIZE is queued so that the input functions report the new size.
+ * The screen is made current for the duration of the call. Note that ncurses builds without a
+ * window list per screen also resize the windows of the other screens which reach the edge.
+ * 
+ * \param lines,cols New size of the terminal.
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::resizeterm(int lines, int cols)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::resizeterm(lines, cols);
+}
+
+/**
+ * \brief Call is_term_resized.
+ * 
+ * \param lines,cols Size to compare with the size of the screen.
+ * \pre %Ncurses mode is on.
+ * \return true if resizeterm would change the size of the screen, false otherwise.
+ */
+inline bool Screen::is_term_resized(int lines, int cols)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	return ::is_term_resized(lines, cols);
+}
+
+/**
+ * \brief Resize the screen to the size of the terminal, if it changed.
+ * 
+ * The size is queried from the terminal output with TIOCGWINSZ, which works for ttys and ptys.
+ * Unlike resizeterm(), no KEY_RESIZE is queued. The whole screen is redrawn by the next update.
+ * This screen is made current while it is resized; the previously current screen is restored after.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::update_terminal_size()
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	winsize size{};
+	if (ioctl(output_fd_, TIOCGWINSZ, &size) == -1)
+		return ERR;
+	return resize_to_(size.ws_row, size.ws_col);
+}
+
+/**
+ * \brief Get the frame scheduler.
+ * 
+ * \return The scheduler coalescing the refreshes of all windows.
+ */
+inline FrameScheduler& Screen::get_frame_scheduler()
+{
+	return scheduler_;
+}
+
+#ifdef NCCPP_WINDOW_REGISTRY
+// Debugging
+
+/**
+ * \brief Get the number of live windows.
+ * 
+ * Every Window, Subwindow and Pad object is counted, except the Screen object itself.
+ * Only available when NDEBUG isn't defined or NCCPP_INSTRUMENTATION is defined.
+ * 
+ * \return The number of live windows.
+ */
+inline std::size_t Screen::live_window_count() const
+{
+	return window_count_;
+}
+
+/**
+ * \brief Print every live window, in creation order.
+ * 
+ * Each line gives the size, the position and the parent of a window, as well as the location
+ * of the code which created it. Only available when NDEBUG isn't defined or NCCPP_INSTRUMENTATION
+ * is defined.
+ * 
+ * \param out The stream to write to.
+ */
+inline void Screen::dump_live_windows(std::FILE* out) const
+{
+	std::unordered_map<WINDOW const*, Window const*> owners;
+	owners.reserve(window_count_);
+	for (auto elem = windows_head_; elem; elem = elem->registry_.next)
+		if (auto handle = elem->debug_handle_())
+			owners.emplace(handle, elem);
+
+	std::fprintf(out, "%zu live window(s)\n", window_count_);
+	for (auto elem = windows_head_; elem; elem = elem->registry_.next)
+	{
+		std::fprintf(out, "  window %p", static_cast<void const*>(elem));
+		if (auto handle = elem->debug_handle_())
+		{
+			std::fprintf(out, " : %dx%d at (%d, %d)", getmaxy(handle), getmaxx(handle), getbegy(handle),
+			             getbegx(handle));
+			auto parent = wgetparent(handle);
+			auto owner = owners.find(parent);
+			if (!parent)
+				std::fprintf(out, ", no parent");
+			else if (parent == stdscr)
+				std::fprintf(out, ", parent stdscr");
+			else if (owner != std::end(owners))
+				std::fprintf(out, ", parent window %p", static_cast<void const*>(owner->second));
+			else
+				std::fprintf(out, ", unmanaged parent WINDOW %p", static_cast<void const*>(parent));
+		}
+		else
+			std::fprintf(out, " : empty");
+		auto const& site = elem->registry_.site;
+		if (site.file)
+			std::fprintf(out, ", created at %s:%d\n", site.file, site.line);
+		else
+			std::fprintf(out, ", created at an unknown location\n");
+	}
+}
+#endif
+
+#ifdef NCCPP_INSTRUMENTATION
+// Instrumentation
+
+/**
+ * \brief Get a snapshot of the rendering counters.
+ * 
+ * The memory of a window is the size of its cells, lines x columns x sizeof(cchar_t). Subwindows
+ * and subpads share the cells of their parent and report 0. Only available when
+ * NCCPP_INSTRUMENTATION is defined.
+ * 
+ * \return The counters of stdscr and of every live window, and the doupdate counters.
+ */
+inline RenderStats Screen::render_stats() const
+{
+	RenderStats stats{{}, doupdates_, doupdate_time_, 0};
+	stats.windows.reserve(window_count_ + 1);
+	auto add = [&stats](Window const& win, WINDOW const* handle)
+	{
+		stats.windows.push_back(win.instrumentation_);
+		auto& entry = stats.windows.back();
+		entry.window = &win;
+		entry.memory = handle && !wgetparent(handle) ? static_cast<std::size_t>(getmaxy(handle)) *
+		                                                   static_cast<std::size_t>(getmaxx(handle)) * sizeof(cchar_t)
+		                                             : 0;
+		stats.memory += entry.memory;
+	};
+	add(*this, win_);
+	for (auto elem = windows_head_; elem; elem = elem->registry_.next)
+		add(*elem, elem->debug_handle_());
+	return stats;
+}
+
+/**
+ * \brief Reset every rendering counter to 0.
+ * 
+ * Only available when NCCPP_INSTRUMENTATION is defined.
+ */
+inline void Screen::reset_render_stats()
+{
+	instrumentation_ = WindowRenderStats{};
+	for (auto elem = windows_head_; elem; elem = elem->registry_.next)
+		elem->instrumentation_ = WindowRenderStats{};
+	doupdates_ = 0;
+	doupdate_time_ = std::chrono::nanoseconds{0};
+}
+#endif
+
+// Window
+
+inline WINDOW* Screen::newwin_(int nlines, int ncols, int begin_y, int begin_x, Window::Key /*dummy*/)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	assert(is_current() && "Screen isn't current");
+	assert(owns_thread_() && "Screen is used from the wrong thread");
+	return newwin(nlines, ncols, begin_y, begin_x);
+}
+
+inline WINDOW* Screen::newpad_(int nlines, int ncols, Window::Key /*dummy*/)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	assert(is_current() && "Screen isn't current");
+	assert(owns_thread_() && "Screen is used from the wrong thread");
+	return newpad(nlines, ncols);
+}
+
+inline void Screen::end_frame_(Window::Key /*dummy*/)
+{}
+
+#ifdef NCCPP_WINDOW_REGISTRY
+inline void Screen::register_window_(Window& new_win, Window::Key /*dummy*/)
+{
+	new_win.registry_.prev = windows_tail_;
+	new_win.registry_.next = nullptr;
+	new_win.registry_.screen = this;
+	(windows_tail_ ? windows_tail_->registry_.next : windows_head_) = &new_win;
+	windows_tail_ = &new_win;
+	++window_count_;
+}
+
+inline void Screen::unregister_window_(Window& win, Window::Key /*dummy*/)
+{
+	auto& link = win.registry_;
+	assert((link.prev || windows_head_ == &win) && "Window isn't registered");
+	(link.prev ? link.prev->registry_.next : windows_head_) = link.next;
+	(link.next ? link.next->registry_.prev : windows_tail_) = link.prev;
+	link.prev = nullptr;
+	link.next = nullptr;
+	link.screen = nullptr;
+	--window_count_;
+}
+#endif
+
+
+// Color
+
+/**
+ * \brief Start ncurses color mode.
+ * 
+ * \pre %Ncurses mode is on.
+ * \exception errors::ColorInit Thrown when colors can't be initialized.
+ */
+inline void Screen::start_color()
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	if (colors_initialized_)
+		return;
+	internal::ScreenScope scope{*this};
+	if (::start_color() == ERR)
+		throw errors::ColorInit{};
+	colors_initialized_ = true;
+}
+
+/**
+ * \brief Start ncurses color mode and register a Palette.
+ * 
+ * Every pair of the palette is registered in one batch and keeps its pair number for the
+ * lifetime of the program, even when color recycling is on.
+ * If a palette entry uses the default color (-1), use_default_colors is called.
+ * 
+ * \tparam P The Palette to register.
+ * \pre %Ncurses mode is on.
+ * \exception errors::ColorInit Thrown when colors can't be initialized.
+ * \exception errors::PaletteInit Thrown if a color has already been registered, since the palette
+ * needs the first pairs.
+ * \exception errors::TooMuchColors Thrown if a pair of the palette can't be registered. No color
+ * is registered then.
+ */
+template <typename P>
+void Screen::start_color()
+{
+	register_palette_(P::colors(), P::size);
+}
+
+/**
+ * \brief Call use_default_colors.
+ * 
+ * \pre %Ncurses mode is on.
+ * \return The result of the operation.
+ */
+inline int Screen::use_default_colors()
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	start_color();
+	auto ret = ::use_default_colors();
+	default_colors_ = default_colors_ || ret == OK;
+	return ret;
+}
+
+/**
+ * \brief Get a pair number from a Color.
+ * 
+ * Registered colors are indexed in a hash table, so this function runs in constant time.
+ * 
+ * \param color The color to get.
+ * \pre %Ncurses mode is on.
+ * \exception errors::TooMuchColors Thrown if no more color pairs can be registered and no pair can
+ * be recycled.
+ * \return The pair number associated with the color.
+ */
+inline short Screen::color_to_pair_number(Color const& color)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	auto it = color_index_.find(color);
+	if (it != std::end(color_index_))
+	{
+		++color_stats_.hits;
+		if (recycle_colors_ && it->second > pinned_pairs_ && it->second != lru_head_)
+		{
+			unlink_pair_(it->second);
+			link_pair_(it->second);
+		}
+		return it->second;
+	}
+
+	++color_stats_.misses;
+	internal::ScreenScope scope{*this};
+	start_color();
+	auto max_pairs = std::min(COLOR_PAIRS, std::numeric_limits<short>::max() + 1);
+	if (registered_colors_.size() + 1 < static_cast<std::size_t>(max_pairs))
+		return register_pair_(color);
+	if (!recycle_colors_ || !lru_tail_)
+		throw errors::TooMuchColors{color};
+	return recycle_pair_(color);
+}
+
+/**
+ * \brief Get an attribute character from a Color.
+ * 
+ * \param color The color to get.
+ * \pre %Ncurses mode is on.
+ * \exception errors::TooMuchColors Thrown if no more color pairs can be registered.
+ * \return The attribute associated with the color.
+ */
+inline attr_t Screen::color_to_attr(Color const& color)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	return static_cast<attr_t>(COLOR_PAIR(color_to_pair_number(color)));
+}
+
+/**
+ * \brief Create a style from attributes and a Color.
+ * 
+ * The color is looked up once, so the style can then be drawn without any lookup. If color
+ * recycling is on, the pair of the style may later be reused for another color: palette styles
+ * (Palette::style()) are never recycled.
+ * 
+ * \param a The attributes.
+ * \param color The color.
+ * \pre %Ncurses mode is on.
+ * \exception errors::TooMuchColors Thrown if no more color pairs can be registered.
+ * \return The style.
+ */
+inline Style Screen::make_style(attr_t a, Color const& color)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	return Style{a, color_to_pair_number(color)};
+}
+
+/**
+ * \brief Get a Color from a pair number.
+ * 
+ * \param pair_n The pair number.
+ * \pre %Ncurses mode is on.
+ * \pre *pair_n* is a valid pair number.
+ * \return The color associated with the pair.
+ */
+inline Color Screen::pair_number_to_color(short pair_n)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	assert(static_cast<std::size_t>(pair_n) <= registered_colors_.size() && "No such color");
+	return registered_colors_[static_cast<std::size_t>(pair_n - 1)];
+}
+
+/**
+ * \brief Get a Color from an attribute.
+ * 
+ * \param a The attribute.
+ * \pre %Ncurses mode is on.
+ * \pre The color pair associated with *a* is a valid color attribute.
+ * \return The color associated with the attribute.
+ */
+inline Color Screen::attr_to_color(attr_t a)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	return pair_number_to_color(static_cast<short>(PAIR_NUMBER(static_cast<int>(a))));
+}
+
+/**
+ * \brief Call init_color.
+ * 
+ * \pre %Ncurses mode is on.
+ * \param color,r,g,b Values to pass on to init_color.
+ */
+inline int Screen::init_color(short color, short r, short g, short b)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	internal::ScreenScope scope{*this};
+	start_color();
+	return ::init_color(color, r, g, b);
+}
+
+/**
+ * \brief Change color pair recycling mode.
+ * 
+ * When recycling is on and every color pair is in use, color_to_pair_number() reuses the least
+ * recently used pair instead of throwing errors::TooMuchColors.
+ * Characters already drawn with a recycled pair change color at the next refresh.
+ * 
+ * \param on If true, enable recycling. Else, disable it.
+ */
+inline void Screen::set_color_recycling(bool on)
+{
+	if (on == recycle_colors_)
+		return;
+	std::vector<PairLink> links{};
+	lru_head_ = lru_tail_ = 0;
+	if (on)
+	{
+		links.resize(registered_colors_.size());
+		pair_links_.swap(links);
+		for (auto i = static_cast<std::size_t>(pinned_pairs_); i != registered_colors_.size(); ++i)
+			link_pair_(static_cast<short>(i + 1));
+	}
+	else
+		pair_links_.swap(links);
+	recycle_colors_ = on;
+}
+
+/**
+ * \brief Get the color pair cache counters.
+ * 
+ * \return The counters accumulated since the last reset.
+ */
+inline ColorCacheStats Screen::color_cache_stats() const
+{
+	return color_stats_;
+}
+
+/**
+ * \brief Reset the color pair cache counters.
+ */
+inline void Screen::reset_color_cache_stats()
+{
+	color_stats_ = ColorCacheStats{0, 0, 0};
+}
+
+inline void Screen::register_palette_(Color const* colors, std::size_t n)
+{
+	assert(!is_exit_ && "Ncurses mode is off");
+	// The pairs of the palette would overwrite the registered ones
+	if (!registered_colors_.empty())
+		throw errors::PaletteInit{};
+	internal::ScreenScope scope{*this};
+	start_color();
+	if (std::any_of(colors, colors + n,
+	                [](Color const& c){return c.foreground < 0 || c.background < 0;}))
+		use_default_colors();
+	try
+	{
+		registered_colors_.reserve(n);
+		color_index_.reserve(n);
+		for (std::size_t i{0}; i != n; ++i)
+		{
+			auto pair_n = static_cast<short>(i + 1);
+			if (init_pair(pair_n, colors[i].foreground, colors[i].background) == ERR)
+				throw errors::TooMuchColors{colors[i]};
+			color_index_.emplace(colors[i], pair_n);
+			registered_colors_.push_back(colors[i]);
+			if (recycle_colors_)
+				pair_links_.push_back(PairLink{0, 0});
+		}
+	}
+	catch (...)
+	{
+		// Nothing was registered before, so the index matches the pair numbers again
+		color_index_.clear();
+		registered_colors_.clear();
+		pair_links_.clear();
+		pinned_pairs_ = 0;
+		throw;
+	}
+	pinned_pairs_ = static_cast<short>(n);
+}
+
+inline short Screen::register_pair_(Color const& color)
+{
+	auto pair_n = static_cast<short>(registered_colors_.size() + 1);
+	// Ensure push_back will not throw
+	registered_colors_.reserve(registered_colors_.size() + 1);
+	if (recycle_colors_)
+		pair_links_.reserve(pair_links_.size() + 1);
+	if (!default_colors_ && (color.foreground < 0 || color.background < 0))
+		use_default_colors();
+	if (init_pair(pair_n, color.foreground, color.background) == ERR)
+		throw errors::TooMuchColors{color};
+	color_index_.emplace(color, pair_n);
+	registered_colors_.push_back(color);
+	if (recycle_colors_)
+	{
+		pair_links_.push_back(PairLink{0, 0});
+		link_pair_(pair_n);
+	}
+	return pair_n;
+}
+
+inline short Screen::recycle_pair_(Color const& color)
+{
+	auto pair_n = lru_tail_;
+	if (!default_colors_ && (color.foreground < 0 || color.background < 0))
+		use_default_colors();
+	if (init_pair(pair_n, color.foreground, color.background) == ERR)
+		throw errors::TooMuchColors{color};
+	auto& slot = registered_colors_[static_cast<std::size_t>(pair_n - 1)];
+	color_index_.erase(slot);
+	slot = color;
+	color_index_.emplace(color, pair_n);
+	unlink_pair_(pair_n);
+	link_pair_(pair_n);
+	++color_stats_.evictions;
+	return pair_n;
+}
+
+inline void Screen::link_pair_(short pair_n)
+{
+	auto& link = pair_links_[static_cast<std::size_t>(pair_n - 1)];
+	link.prev = 0;
+	link.next = lru_head_;
+	if (lru_head_)
+		pair_links_[static_cast<std::size_t>(lru_head_ - 1)].prev = pair_n;
+	else
+		lru_tail_ = pair_n;
+	lru_head_ = pair_n;
+}
+
+inline void Screen::unlink_pair_(short pair_n)
+{
+	auto& link = pair_links_[static_cast<std::size_t>(pair_n - 1)];
+	if (link.prev)
+		pair_links_[static_cast<std::size_t>(link.prev - 1)].next = link.next;
+	else
+		lru_head_ = link.next;
+	if (link.next)
+		pair_links_[static_cast<std::size_t>(link.next - 1)].prev = link.prev;
+	else
+		lru_tail_ = link.prev;
+}
+
+inline int Screen::resize_to_(int lines, int cols)
+{
+	if (lines <= 0 || cols <= 0)
+		return ERR;
+	internal::ScreenScope scope{*this};
+	if (!(this->is_term_resized)(lines, cols))
+		return OK;
+	if (::resize_term(lines, cols) == ERR)
+		return ERR;
+	return (this->clearok)(true, true);
+}
+
+inline void Screen::end_screen_()
+{
+	auto previous = set_term(screen_);
+	endwin();
+	win_ = nullptr;
+	auto& ended = internal::ended_screens();
+	ended.screens.push_back(screen_);
+	screen_ = nullptr;
+	if (--ended.live_count == 0)
+	{
+		for (auto screen : ended.screens)
+			delscreen(screen);
+		ended.screens.clear();
+	}
+	else if (previous != ended.screens.back())
+		set_term(previous);
+}
+
+inline void Screen::assign(WINDOW*)
+{
+	assert(false && "Can't call nccpp::Screen::assign");
+}
+
+inline void Screen::destroy()
+{
+	assert(false && "Can't call nccpp::Screen::destroy");
+}
+
+
+} // namespace nccpp
+
+#endif // Header guard
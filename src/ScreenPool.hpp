@@ -0,0 +1,176 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+/**
+ * \file ScreenPool.hpp
+ * \brief Header file for the ScreenPool class.
+ */
+
+#ifndef NCURSESCPP_SCREENPOOL_HPP_
+#define NCURSESCPP_SCREENPOOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+#ifndef NCCPP_DRAWQUEUE_NOIMPL
+#define NCCPP_DRAWQUEUE_NOIMPL
+#include "DrawQueue.hpp"
+#undef NCCPP_DRAWQUEUE_NOIMPL
+#else
+#include "DrawQueue.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Counters describing the behaviour of a ScreenPool.
+ */
+struct ScreenPoolStats
+{
+	std::size_t frames;  ///< Calls to ScreenPool::render().
+	std::size_t updates; ///< Screens which had commands to apply or windows to flush, summed over the frames.
+	std::size_t applied; ///< Draw commands applied, summed over the frames.
+};
+
+/**
+ * \brief Render several screens with a pool of worker threads, serializing their updates.
+ * 
+ * Only the prepare step runs in parallel: applying the commands and calling doupdate are serialized
+ * under internal::ncurses_mutex(), because ncurses isn't reentrant.
+ * 
+ * Each screen added to the pool is bound to one worker, and only this worker may use it until the
+ * pool is destroyed. In debug mode, making the screen current, updating it, creating windows on it
+ * or refreshing its windows from another thread fails an assertion; other misuses aren't detected.
+ * 
+ * A frame runs in two steps for each screen. First the prepare function of the screen builds the
+ * frame as draw commands in the DrawQueue of the screen. It must not call ncurses, so the workers
+ * run it in parallel. Then the worker makes the screen current, applies the commands and updates
+ * the terminal, flushing the frame scheduler of the screen when it coalesces refreshes. This second
+ * step holds the lock shared by every pool: while one worker updates its screen, the others prepare
+ * theirs.
+ */
+class ScreenPool
+{
+	public:
+	/// Called by a worker to queue the commands of a frame. Mustn't call ncurses.
+	using Prepare = std::function<void(Screen&, DrawQueue&)>;
+
+	explicit ScreenPool(std::size_t = 0);
+
+	/// \cond NODOC
+	ScreenPool(ScreenPool const&) = delete;
+	ScreenPool& operator=(ScreenPool const&) = delete;
+
+	ScreenPool(ScreenPool&&) = delete;
+	ScreenPool& operator=(ScreenPool&&) = delete;
+	/// \endcond
+
+	~ScreenPool();
+
+	DrawQueue& add(Screen&, Prepare = nullptr);
+	std::size_t screen_count() const;
+	std::size_t thread_count() const;
+
+	void render();
+
+	ScreenPoolStats stats() const;
+	void reset_stats();
+
+	private:
+	/// \cond NODOC
+	struct Entry
+	{
+		Screen* screen;
+		Prepare prepare;
+		DrawQueue queue;
+	};
+	/// \endcond
+
+	std::vector<std::unique_ptr<Entry>> entries_;
+	std::vector<std::thread> workers_;
+	std::vector<std::thread::id> worker_ids_;
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable done_;
+	std::size_t generation_;
+	std::size_t running_;
+	bool stop_;
+	std::exception_ptr error_;
+	ScreenPoolStats stats_;
+
+	void work_(std::size_t);
+	void shut_down_();
+};
+
+/// \cond NODOC
+namespace internal
+{
+
+// Serializes the ncurses calls of the pool workers, since ncurses isn't reentrant
+inline std::mutex& ncurses_mutex()
+{
+	static std::mutex mutex{};
+	return mutex;
+}
+
+} // namespace internal
+/// \endcond
+
+} // namespace nccpp
+
+#ifndef NCCPP_SCREENPOOL_NOIMPL
+#include "Ncurses.hpp"
+
+#include "DrawQueue.ipp"
+#include "ScreenPool.ipp"
+#endif
+
+#endif // Header guard
@@ -0,0 +1,245 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+#ifndef NCURSESCPP_SCREENPOOL_IPP_
+#define NCURSESCPP_SCREENPOOL_IPP_
+
+#include <algorithm>
+#include <cassert>
+
+namespace nccpp
+{
+
+/**
+ * \brief Start the worker threads.
+ * 
+ * \param threads Number of workers. If 0, one per hardware thread.
+ */
+inline ScreenPool::ScreenPool(std::size_t threads)
+	: entries_{}, workers_{}, worker_ids_{}, mutex_{}, wake_{}, done_{}, generation_{0}, running_{0}, stop_{false},
+	  error_{}, stats_{0, 0, 0}
+{
+	if (!threads)
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	workers_.reserve(threads);
+	worker_ids_.reserve(threads);
+	try
+	{
+		for (std::size_t i{0}; i != threads; ++i)
+		{
+			workers_.emplace_back([this, i]{work_(i);});
+			worker_ids_.push_back(workers_.back().get_id());
+		}
+	}
+	catch (...)
+	{
+		shut_down_();
+		throw;
+	}
+}
+
+/**
+ * \brief Stop the worker threads.
+ * 
+ * The screens can be used by the destroying thread afterwards.
+ */
+inline ScreenPool::~ScreenPool()
+{
+	shut_down_();
+#ifndef NDEBUG
+	for (auto const& entry : entries_)
+		entry->screen->owner_ = std::thread::id{};
+#endif
+}
+
+/**
+ * \brief Add a screen to the pool.
+ * 
+ * The screen is bound to a worker, which uses it for every frame.
+ * Other threads can also push commands to the returned queue, they are applied at the next frame.
+ * 
+ * \param screen The screen to add. It must outlive the pool.
+ * \param prepare Function called at the beginning of each frame, from the worker. Can be empty.
+ * \pre render() isn't running.
+ * \pre The screen isn't in a pool yet.
+ * \return The queue whose commands are applied to the screen.
+ */
+inline DrawQueue& ScreenPool::add(Screen& screen, Prepare prepare)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	assert(!running_ && "Can't add a screen while rendering");
+#ifndef NDEBUG
+	assert(screen.owner_ == std::thread::id{} && "Screen is already in a pool");
+	screen.owner_ = worker_ids_[entries_.size() % worker_ids_.size()];
+#endif
+	entries_.emplace_back(new Entry{&screen, std::move(prepare), {}});
+	return entries_.back()->queue;
+}
+
+/**
+ * \brief Get the number of screens in the pool.
+ * 
+ * \return The number of screens.
+ */
+inline std::size_t ScreenPool::screen_count() const
+{
+	return entries_.size();
+}
+
+/**
+ * \brief Get the number of worker threads.
+ * 
+ * \return The number of workers.
+ */
+inline std::size_t ScreenPool::thread_count() const
+{
+	return workers_.size();
+}
+
+/**
+ * \brief Render a frame on every screen and wait for the workers to finish.
+ * 
+ * The calling thread mustn't use ncurses while the workers run. Afterwards, the screen current
+ * before the call is current again, unless it belongs to the pool.
+ * 
+ * \exception Any exception thrown by a prepare function or by the drawing is rethrown here, once
+ * every worker has finished.
+ */
+inline void ScreenPool::render()
+{
+	auto previous = internal::current_screen_ptr();
+	std::exception_ptr error{};
+	{
+		std::unique_lock<std::mutex> lock{mutex_};
+		assert(!running_ && "The pool is already rendering");
+		running_ = workers_.size();
+		++generation_;
+		++stats_.frames;
+		wake_.notify_all();
+		done_.wait(lock, [this]{return !running_;});
+		std::swap(error, error_);
+	}
+	auto pooled = [previous](std::unique_ptr<Entry> const& entry){return entry->screen == previous;};
+	std::lock_guard<std::mutex> lock{internal::ncurses_mutex()};
+	if (previous && std::none_of(entries_.begin(), entries_.end(), pooled))
+		previous->make_current();
+	else
+		internal::current_screen_ptr() = nullptr;
+	if (error)
+		std::rethrow_exception(error);
+}
+
+/**
+ * \brief Get the pool counters.
+ * 
+ * \return The counters accumulated since the last reset.
+ */
+inline ScreenPoolStats ScreenPool::stats() const
+{
+	return stats_;
+}
+
+/**
+ * \brief Reset the pool counters.
+ */
+inline void ScreenPool::reset_stats()
+{
+	stats_ = ScreenPoolStats{0, 0, 0};
+}
+
+inline void ScreenPool::work_(std::size_t index)
+{
+	std::size_t seen{0};
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock{mutex_};
+			wake_.wait(lock, [this, seen]{return stop_ || generation_ != seen;});
+			if (stop_)
+				return;
+			seen = generation_;
+		}
+
+		// entries_ can't change while the workers run
+		std::exception_ptr error{};
+		std::size_t updates{0}, applied{0};
+		for (auto i = index; i < entries_.size(); i += workers_.size())
+		{
+			auto& entry = *entries_[i];
+			try
+			{
+				if (entry.prepare)
+					entry.prepare(*entry.screen, entry.queue);
+				// A frame rate limit can leave windows scheduled by a previous frame
+				auto& scheduler = entry.screen->get_frame_scheduler();
+				if (!entry.queue.depth() && !scheduler.pending())
+					continue;
+				std::lock_guard<std::mutex> lock{internal::ncurses_mutex()};
+				entry.screen->make_current();
+				applied += entry.queue.drain();
+				scheduler.flush();
+				++updates;
+			}
+			catch (...)
+			{
+				if (!error)
+					error = std::current_exception();
+			}
+		}
+
+		std::lock_guard<std::mutex> lock{mutex_};
+		stats_.updates += updates;
+		stats_.applied += applied;
+		if (error && !error_)
+			error_ = error;
+		if (!--running_)
+			done_.notify_one();
+	}
+}
+
+inline void ScreenPool::shut_down_()
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		stop_ = true;
+	}
+	wake_.notify_all();
+	for (auto& worker : workers_)
+		worker.join();
+}
+
+} // namespace nccpp
+
+#endif // Header guard
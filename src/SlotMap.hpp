@@ -0,0 +1,298 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file SlotMap.hpp
+ * \brief Header file for the generational handles to subwindows and subpads.
+ */
+
+#ifndef NCURSESCPP_SLOTMAP_HPP_
+#define NCURSESCPP_SLOTMAP_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace nccpp
+{
+
+/**
+ * \brief Generational handle to an object owned by a window, such as a subwindow.
+ * 
+ * A handle stays valid until the object is deleted. Handles to deleted objects are detected in
+ * constant time, even after their slot has been reused for another object. A default constructed
+ * handle is never valid.
+ */
+template <typename T>
+struct Handle
+{
+	/// \cond NODOC
+	Handle() = default;
+	Handle(std::uint32_t slot_index, std::uint32_t slot_generation)
+		: index{slot_index}, generation{slot_generation}
+	{
+	}
+	/// \endcond
+
+	std::uint32_t index{0};      ///< Index of the slot holding the object.
+	std::uint32_t generation{0}; ///< Generation of the slot when the object was created, 0 if never valid.
+};
+
+/**
+ * \brief Compare two handles.
+ * 
+ * \return true if both handles refer to the same object.
+ */
+template <typename T>
+inline bool operator==(Handle<T> const& lhs, Handle<T> const& rhs)
+{
+	return lhs.index == rhs.index && lhs.generation == rhs.generation;
+}
+
+/**
+ * \brief Compare two handles.
+ * 
+ * \return true if the handles refer to different objects.
+ */
+template <typename T>
+inline bool operator!=(Handle<T> const& lhs, Handle<T> const& rhs)
+{
+	return !(lhs == rhs);
+}
+
+/// \cond NODOC
+namespace internal
+{
+
+// Objects are stored in fixed-size pages, so they are never moved once constructed : references stay
+// valid and the debug window registry, which records addresses, doesn't need updating. Vacant slots
+// are chained in a free list and reused before new slots are created.
+template <typename T>
+class SlotMap
+{
+	public:
+	SlotMap()
+		: pages_{}, slot_count_{0}, free_head_{npos}, size_{0}, min_generation_{1}
+	{}
+
+	SlotMap(SlotMap const&) = delete;
+	SlotMap& operator=(SlotMap const&) = delete;
+
+	SlotMap(SlotMap&& mv) noexcept
+		: pages_{std::move(mv.pages_)}, slot_count_{mv.slot_count_}, free_head_{mv.free_head_}, size_{mv.size_},
+		  min_generation_{mv.min_generation_}
+	{
+		mv.pages_.clear();
+		mv.slot_count_ = 0;
+		mv.free_head_ = npos;
+		mv.size_ = 0;
+	}
+
+	SlotMap& operator=(SlotMap&& mv) noexcept
+	{
+		if (this != &mv)
+		{
+			clear();
+			pages_ = std::move(mv.pages_);
+			slot_count_ = mv.slot_count_;
+			free_head_ = mv.free_head_;
+			size_ = mv.size_;
+			min_generation_ = std::max(min_generation_, mv.min_generation_);
+			mv.pages_.clear();
+			mv.slot_count_ = 0;
+			mv.free_head_ = npos;
+			mv.size_ = 0;
+		}
+		return *this;
+	}
+
+	~SlotMap()
+	{
+		clear();
+	}
+
+	template <typename... Args>
+	Handle<T> emplace(Args&&... args)
+	{
+		std::uint32_t index{free_head_};
+		if (index == npos)
+		{
+			if (slot_count_ % page_size == 0)
+				pages_.emplace_back(new Slot[page_size]);
+			index = slot_count_;
+			slot_(index).generation = min_generation_;
+		}
+		auto& slot = slot_(index);
+		::new (static_cast<void*>(slot.storage)) T(std::forward<Args>(args)...);
+		if (index == free_head_)
+			free_head_ = slot.next_free;
+		else
+			++slot_count_;
+		slot.live = true;
+		++size_;
+		return Handle<T>{index, slot.generation};
+	}
+
+	bool contains(Handle<T> handle) const
+	{
+		if (handle.index >= slot_count_)
+			return false;
+		auto const& slot = pages_[handle.index / page_size][handle.index % page_size];
+		return slot.live && slot.generation == handle.generation;
+	}
+
+	T& get(Handle<T> handle)
+	{
+		assert(contains(handle) && "Invalid or stale handle");
+		return slot_(handle.index).get();
+	}
+
+	void erase(Handle<T> handle)
+	{
+		assert(contains(handle) && "Invalid or stale handle");
+		release_(handle.index);
+	}
+
+	// Destroy every object. The slots are kept, so existing handles are still detected as stale.
+	void clear()
+	{
+		for (std::uint32_t i{slot_count_}; i != 0; --i)
+			if (slot_(i - 1).live)
+				release_(i - 1);
+	}
+
+	// Free the trailing pages which don't hold any object. Handles are not invalidated.
+	void compact()
+	{
+		while (!pages_.empty())
+		{
+			auto first = static_cast<std::uint32_t>((pages_.size() - 1) * page_size);
+			std::uint32_t max_generation{0};
+			bool empty{true};
+			for (std::uint32_t i{first}; i != slot_count_ && empty; ++i)
+			{
+				empty = !slot_(i).live;
+				max_generation = std::max(max_generation, slot_(i).generation);
+			}
+			if (!empty)
+				break;
+			// New slots must not reuse a generation a stale handle may hold
+			min_generation_ = std::max(min_generation_, next_generation_(max_generation));
+			pages_.pop_back();
+			slot_count_ = first;
+		}
+		pages_.shrink_to_fit();
+		free_head_ = npos;
+		for (std::uint32_t i{slot_count_}; i != 0; --i)
+			if (!slot_(i - 1).live)
+			{
+				slot_(i - 1).next_free = free_head_;
+				free_head_ = i - 1;
+			}
+	}
+
+	std::size_t size() const
+	{
+		return size_;
+	}
+
+	std::size_t slot_count() const
+	{
+		return slot_count_;
+	}
+
+	private:
+	static std::size_t constexpr page_size{16};
+	static std::uint32_t constexpr npos{UINT32_MAX};
+
+	struct Slot
+	{
+		alignas(T) unsigned char storage[sizeof(T)];
+		std::uint32_t generation{0};
+		std::uint32_t next_free{npos};
+		bool live{false};
+
+		T& get()
+		{
+			return *reinterpret_cast<T*>(storage);
+		}
+	};
+
+	Slot& slot_(std::uint32_t index)
+	{
+		return pages_[index / page_size][index % page_size];
+	}
+
+	static std::uint32_t next_generation_(std::uint32_t generation)
+	{
+		return generation == UINT32_MAX ? 1 : generation + 1;
+	}
+
+	void release_(std::uint32_t index)
+	{
+		auto& slot = slot_(index);
+		slot.live = false;
+		slot.generation = next_generation_(slot.generation);
+		slot.next_free = free_head_;
+		free_head_ = index;
+		--size_;
+		slot.get().~T();
+	}
+
+	std::vector<std::unique_ptr<Slot[]>> pages_;
+	std::uint32_t slot_count_;
+	std::uint32_t free_head_;
+	std::size_t size_;
+	std::uint32_t min_generation_;
+};
+
+template <typename T>
+std::size_t constexpr SlotMap<T>::page_size;
+
+template <typename T>
+std::uint32_t constexpr SlotMap<T>::npos;
+
+} // namespace internal
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
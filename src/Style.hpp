@@ -0,0 +1,204 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file Style.hpp
+ * \brief Header file for the Style class and the StyledRun structure used by Window::add_runs.
+ */
+
+#ifndef NCURSESCPP_STYLE_HPP_
+#define NCURSESCPP_STYLE_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#ifndef NCURSES_NOMACROS
+#define NCURSES_NOMACROS
+#endif
+
+#ifndef NCURSES_WIDECHAR
+#define NCURSES_WIDECHAR 1
+#endif
+
+#include <ncurses.h>
+
+namespace nccpp
+{
+
+/**
+ * \brief Immutable set of attributes with a resolved color pair.
+ * 
+ * A style is computed once, with Screen::make_style() or Palette::style(), and then used by
+ * Window::attr_set(), Window::chgat() and Window::add_runs() without looking up the color again.
+ * The pair number belongs to the screen which resolved it.
+ */
+class Style
+{
+	public:
+	/**
+	 * \brief Create the style of normal text, with the default pair.
+	 */
+	constexpr Style() : Style{A_NORMAL, 0} {}
+
+	/**
+	 * \brief Create a style from attributes and a pair number.
+	 * 
+	 * \param a The attributes. Color bits are ignored.
+	 * \param pair_n The pair number.
+	 */
+	constexpr Style(attr_t a, short pair_n) : attributes_{a & ~A_COLOR}, pair_number_{pair_n} {}
+
+	/**
+	 * \brief Get the attributes of the style, without the color.
+	 * 
+	 * \return The attributes.
+	 */
+	constexpr attr_t attributes() const
+	{
+		return attributes_;
+	}
+
+	/**
+	 * \brief Get the pair number of the style.
+	 * 
+	 * \return The pair number.
+	 */
+	constexpr short pair_number() const
+	{
+		return pair_number_;
+	}
+
+	/**
+	 * \brief Get the attributes of the style, with the color.
+	 * 
+	 * The result can be passed on to Window::attrset() or combined with characters.
+	 * 
+	 * \return The attributes combined with the color pair.
+	 */
+	constexpr attr_t attr() const
+	{
+		// COLOR_PAIR is a function when NCURSES_NOMACROS is defined
+		return attributes_ | static_cast<attr_t>(NCURSES_BITS(pair_number_, 0) & A_COLOR);
+	}
+
+	/**
+	 * \brief Get a copy of the style with more attributes.
+	 * 
+	 * \param a The attributes to add.
+	 * \return The new style.
+	 */
+	constexpr Style with(attr_t a) const
+	{
+		return Style{attributes_ | a, pair_number_};
+	}
+
+	/**
+	 * \brief Get a copy of the style with less attributes.
+	 * 
+	 * \param a The attributes to remove.
+	 * \return The new style.
+	 */
+	constexpr Style without(attr_t a) const
+	{
+		return Style{attributes_ & ~a, pair_number_};
+	}
+
+	private:
+	attr_t attributes_;
+	short pair_number_;
+};
+
+constexpr bool operator==(Style const& lhs, Style const& rhs)
+{
+	return lhs.attributes() == rhs.attributes() && lhs.pair_number() == rhs.pair_number();
+}
+
+constexpr bool operator!=(Style const& lhs, Style const& rhs)
+{
+	return !(lhs == rhs);
+}
+
+/**
+ * \brief Text written with a style, as passed on to Window::add_runs.
+ * 
+ * The run doesn't own the text, which must outlive it.
+ */
+struct StyledRun
+{
+	/**
+	 * \brief Create a run from a null-terminated string.
+	 * 
+	 * \param str The text.
+	 * \param s The style of the text.
+	 */
+	StyledRun(char const* str, Style s) : StyledRun{str, std::strlen(str), s} {}
+
+	/**
+	 * \brief Create a run from the first characters of a string.
+	 * 
+	 * \param str The text.
+	 * \param n The number of bytes of the text.
+	 * \param s The style of the text.
+	 */
+	constexpr StyledRun(char const* str, std::size_t n, Style s) : text{str}, length{n}, style{s} {}
+
+	/**
+	 * \brief Create a run from a string.
+	 * 
+	 * \param str The text.
+	 * \param s The style of the text.
+	 */
+	StyledRun(std::string const& str, Style s) : StyledRun{str.data(), str.size(), s} {}
+
+#ifdef NCCPP_HAS_STRING_VIEW
+	/**
+	 * \brief Create a run from a string view.
+	 * 
+	 * \param str The text.
+	 * \param s The style of the text.
+	 */
+	constexpr StyledRun(std::string_view str, Style s) : StyledRun{str.data(), str.size(), s} {}
+#endif
+
+	char const* text;   ///< The text, not necessarily null-terminated.
+	std::size_t length; ///< Number of bytes of the text.
+	Style style;        ///< Style of the text.
+};
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -63,8 +63,8 @@ class Subwindow : public Window
 {
 	public:
 	/// \cond NODOC
-	Subwindow(Window& parent, WINDOW* subwin, Window::Key /*dummy*/)
-		: Window{subwin}, parent_{parent}
+	Subwindow(Window& parent, WINDOW* subwin, Window::Key /*dummy*/ NCCPP_SITE_DEF)
+		: Window{subwin NCCPP_SITE_FWD}, parent_{parent}
 	{}
 
 	Subwindow(Subwindow const&) = delete;
@@ -79,6 +79,7 @@ class Subwindow : public Window
 	Window& get_parent();
 
 	int mvderwin(int, int);
+	int move_to(int, int);
 
 	void syncup();
 	int syncok(bool);
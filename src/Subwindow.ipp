@@ -66,6 +66,26 @@ inline int Subwindow::mvderwin(int y, int x)
 	return ::mvderwin(win_, y, x);
 }
 
+/**
+ * \brief Move the subwindow inside its parent.
+ * 
+ * mvderwin only changes the cells of the parent the subwindow shows, and mvwin only its position
+ * on the screen, so both are called. Subwindows of this subwindow aren't moved.
+ * 
+ * \param y,x New position, relative to the parent.
+ * \pre The Subwindow manages a ncurses window.
+ * \pre The subwindow fits in its parent at the new position.
+ * \return The result of the operation.
+ */
+inline int Subwindow::move_to(int y, int x)
+{
+	assert(win_ && "Invalid subwindow");
+	auto parent = wgetparent(win_);
+	if (::mvderwin(win_, y, x) == ERR)
+		return ERR;
+	return ::mvwin(win_, getbegy(parent) + y, getbegx(parent) + x);
+}
+
 /**
  * \brief Call wsyncup for this subwindow.
  * 
@@ -0,0 +1,129 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file TailView.hpp
+ * \brief Header file for the TailView class.
+ */
+
+#ifndef NCURSESCPP_TAILVIEW_HPP_
+#define NCURSESCPP_TAILVIEW_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief Counters describing the behaviour of a TailView.
+ */
+struct TailStats
+{
+	std::size_t appended; ///< Lines appended.
+	std::size_t drawn;    ///< Lines written to the window.
+	std::size_t scrolls;  ///< Scrolls of the region, at most one per flush.
+	std::size_t redraws;  ///< Flushes which had to redraw the whole region.
+};
+
+/**
+ * \brief Region of a window showing the last lines of a stream, such as a log.
+ * 
+ * Appended lines are stored in a ring buffer. flush() scrolls the region once by the number of
+ * lines appended since the previous flush and only writes the new lines. The region is set as the
+ * scrolling region of the window and idlok is enabled, so ncurses can use the terminal scroll
+ * region and each new line costs a scroll plus one line of output.
+ * The view assumes it is the only thing writing in its region.
+ */
+class TailView
+{
+	public:
+	TailView(Window&, std::size_t, int = 0, int = 0);
+
+	/// \cond NODOC
+	TailView(TailView const&) = delete;
+	TailView& operator=(TailView const&) = delete;
+
+	TailView(TailView&&) = default;
+	TailView& operator=(TailView&&) = delete;
+	/// \endcond
+
+	~TailView() = default;
+
+	Window& get_window();
+	std::size_t get_capacity() const;
+	std::size_t line_count() const;
+	std::string const& get_line(std::size_t) const;
+
+	void append(std::string const&);
+	void append(char const*, std::size_t);
+	void clear();
+	void invalidate();
+
+	int flush();
+	int refresh();
+
+	TailStats const& tail_stats() const;
+	void reset_tail_stats();
+
+	private:
+	Window& win_;
+	std::vector<std::string> lines_;
+	std::size_t head_;
+	std::size_t count_;
+	std::size_t pending_;
+	int top_;
+	int height_;
+	bool full_redraw_;
+	TailStats stats_;
+
+	int draw_line_(int, std::string const*);
+};
+
+} // namespace nccpp
+
+#include "TailView.ipp"
+
+#endif // Header guard
@@ -0,0 +1,276 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+#ifndef NCURSESCPP_TAILVIEW_IPP_
+#define NCURSESCPP_TAILVIEW_IPP_
+
+#include <algorithm>
+#include <cassert>
+
+namespace nccpp
+{
+
+/**
+ * \brief Create a tail view over a region of a window.
+ * 
+ * The region spans the whole width of the window. It becomes the scrolling region of the window,
+ * and idlok is enabled for the window.
+ * 
+ * \param win The window to draw into. It must outlive the view.
+ * \param capacity Number of lines kept in memory. It is raised to the height of the region if lower.
+ * \param top First line of the region in the window.
+ * \param lines Height of the region, or 0 to extend it to the bottom of the window.
+ * \pre The Window manages a ncurses window.
+ * \pre The region is inside the window.
+ */
+inline TailView::TailView(Window& win, std::size_t capacity, int top, int lines)
+	: win_{win}, lines_{}, head_{0}, count_{0}, pending_{0}, top_{top}, height_{lines},
+	  full_redraw_{true}, stats_{0, 0, 0, 0}
+{
+	WINDOW* handle{win_.get_handle()};
+	assert(handle && "Window doesn't manage any object");
+	if (height_ == 0)
+		height_ = getmaxy(handle) - top_;
+	assert(top_ >= 0 && height_ > 0 && top_ + height_ <= getmaxy(handle) && "Invalid region");
+	lines_.resize(std::max(capacity, static_cast<std::size_t>(height_)));
+	wsetscrreg(handle, top_, top_ + height_ - 1);
+	::idlok(handle, TRUE);
+}
+
+/**
+ * \brief Get the window the view draws into.
+ * 
+ * \return The window.
+ */
+inline Window& TailView::get_window()
+{
+	return win_;
+}
+
+/**
+ * \brief Get the number of lines kept in memory.
+ * 
+ * \return The capacity of the ring buffer.
+ */
+inline std::size_t TailView::get_capacity() const
+{
+	return lines_.size();
+}
+
+/**
+ * \brief Get the number of lines currently kept in memory.
+ * 
+ * \return The number of lines, at most get_capacity().
+ */
+inline std::size_t TailView::line_count() const
+{
+	return count_;
+}
+
+/**
+ * \brief Get a line kept in memory.
+ * 
+ * \param index Index of the line, 0 being the oldest line kept.
+ * \pre index < line_count()
+ * \return The line.
+ */
+inline std::string const& TailView::get_line(std::size_t index) const
+{
+	assert(index < count_ && "Invalid line index");
+	return lines_[(head_ + index) % lines_.size()];
+}
+
+/**
+ * \brief Append a line.
+ * 
+ * When the ring buffer is full, the oldest line is dropped. The line is drawn by the next flush.
+ * 
+ * \param line The line to append. It is truncated to the width of the window when drawn and
+ * must not contain control characters such as newlines.
+ */
+inline void TailView::append(std::string const& line)
+{
+	(this->append)(line.data(), line.size());
+}
+
+/**
+ * \brief Append a line.
+ * 
+ * When the ring buffer is full, the oldest line is dropped. The line is drawn by the next flush.
+ * 
+ * \param line The line to append. It is truncated to the width of the window when drawn and
+ * must not contain control characters such as newlines.
+ * \param n Length of the line.
+ */
+inline void TailView::append(char const* line, std::size_t n)
+{
+	auto capacity = lines_.size();
+	if (count_ == capacity)
+	{
+		lines_[head_].assign(line, n);
+		head_ = (head_ + 1) % capacity;
+	}
+	else
+		lines_[(head_ + count_++) % capacity].assign(line, n);
+	++pending_;
+	++stats_.appended;
+}
+
+/**
+ * \brief Drop all the lines.
+ * 
+ * The region is blanked by the next flush.
+ */
+inline void TailView::clear()
+{
+	head_ = 0;
+	count_ = 0;
+	pending_ = 0;
+	full_redraw_ = true;
+}
+
+/**
+ * \brief Make the next flush redraw the whole region.
+ */
+inline void TailView::invalidate()
+{
+	full_redraw_ = true;
+}
+
+/**
+ * \brief Draw the lines appended since the last flush.
+ * 
+ * The region is scrolled once by the number of new lines, which are then written at its bottom.
+ * If at least a region worth of lines was appended, the region is redrawn instead.
+ * The window isn't refreshed and its cursor position is left unchanged.
+ * 
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int TailView::flush()
+{
+	WINDOW* win{win_.get_handle()};
+	assert(win && "Window doesn't manage any object");
+	auto height = static_cast<std::size_t>(height_);
+	if (!full_redraw_ && pending_ == 0)
+		return OK;
+
+	int cur_y{getcury(win)}, cur_x{getcurx(win)};
+	int ret{OK};
+	std::size_t first_line{0};
+	if (full_redraw_ || pending_ >= height)
+		++stats_.redraws;
+	else
+	{
+		first_line = height - pending_;
+		scrollok(win, TRUE);
+		ret = wscrl(win, static_cast<int>(pending_));
+		scrollok(win, FALSE);
+		++stats_.scrolls;
+	}
+	// Line i of the region shows the line count_ - height + i of the buffer, if there is one.
+	for (auto i = first_line; i != height; ++i)
+	{
+		std::string const* line{count_ + i >= height ? &(this->get_line)(count_ + i - height) : nullptr};
+		if ((this->draw_line_)(top_ + static_cast<int>(i), line) == ERR)
+			ret = ERR;
+	}
+
+	wmove(win, cur_y, cur_x);
+	pending_ = 0;
+	full_redraw_ = false;
+	return ret;
+}
+
+/**
+ * \brief Flush the view and refresh its window.
+ * 
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int TailView::refresh()
+{
+	return (this->flush)() == ERR ? ERR : win_.refresh();
+}
+
+/**
+ * \brief Get the view counters.
+ * 
+ * \return The counters accumulated since the creation of the view or the last reset.
+ */
+inline TailStats const& TailView::tail_stats() const
+{
+	return stats_;
+}
+
+/**
+ * \brief Reset the view counters.
+ */
+inline void TailView::reset_tail_stats()
+{
+	stats_ = TailStats{0, 0, 0, 0};
+}
+
+/// \cond NODOC
+inline int TailView::draw_line_(int y, std::string const* line)
+{
+	WINDOW* win{win_.get_handle()};
+	if (wmove(win, y, 0) == ERR)
+		return ERR;
+	auto width = static_cast<std::size_t>(getmaxx(win));
+	auto n = line ? std::min(line->size(), width) : 0;
+	int ret{OK};
+	if (n != 0)
+	{
+		// Writing the last column wraps the cursor, which fails on the bottom row without scrollok,
+		// so the last cell is inserted without moving the cursor
+		auto head = n == width ? n - 1 : n;
+		if (head != 0)
+			ret = waddnstr(win, line->data(), static_cast<int>(head));
+		if (head != n && winsch(win, static_cast<chtype>(static_cast<unsigned char>((*line)[head]))) == ERR)
+			ret = ERR;
+		++stats_.drawn;
+		NCCPP_RECORD_OUTPUT(win_, addstr, n);
+	}
+	if (n < width)
+		wclrtoeol(win);
+	return ret;
+}
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
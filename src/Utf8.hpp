@@ -0,0 +1,179 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+
+/**
+ * \file Utf8.hpp
+ * \brief Header file for the UTF-8 helpers used by Window::add_utf8.
+ */
+
+#ifndef NCURSESCPP_UTF8_HPP_
+#define NCURSESCPP_UTF8_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+
+/// \cond NODOC
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NCCPP_HAS_SSE2
+#endif
+/// \endcond
+
+namespace nccpp
+{
+
+/// \cond NODOC
+namespace internal
+{
+
+char32_t constexpr utf8_replacement{0xFFFD};
+
+// Number of leading bytes of str which are 7-bit ASCII, checked 16 (SSE2) or 8 bytes at a time
+inline std::size_t ascii_prefix(char const* str, std::size_t n)
+{
+	std::size_t i{0};
+#ifdef NCCPP_HAS_SSE2
+	for (; i + 16 <= n; i += 16)
+	{
+		auto mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(str + i)));
+		if (mask != 0)
+		{
+			while ((mask & 1) == 0)
+			{
+				mask >>= 1;
+				++i;
+			}
+			return i;
+		}
+	}
+#endif
+	for (; i + 8 <= n; i += 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, str + i, sizeof(word));
+		if ((word & 0x8080808080808080u) != 0)
+			break;
+	}
+	while (i != n && static_cast<unsigned char>(str[i]) < 0x80)
+		++i;
+	return i;
+}
+
+// Decode the code point starting at str and advance str past it. Malformed, overlong and surrogate
+// sequences decode to U+FFFD and only consume their first byte.
+inline char32_t decode_utf8(char const*& str, char const* end)
+{
+	auto const* s = reinterpret_cast<unsigned char const*>(str);
+	auto avail = static_cast<std::size_t>(end - str);
+	char32_t cp{s[0]};
+	std::size_t len{1};
+	char32_t min{0};
+	if (cp < 0x80)
+	{
+		++str;
+		return cp;
+	}
+	else if ((cp & 0xE0) == 0xC0)
+	{
+		len = 2;
+		cp &= 0x1F;
+		min = 0x80;
+	}
+	else if ((cp & 0xF0) == 0xE0)
+	{
+		len = 3;
+		cp &= 0x0F;
+		min = 0x800;
+	}
+	else if ((cp & 0xF8) == 0xF0)
+	{
+		len = 4;
+		cp &= 0x07;
+		min = 0x10000;
+	}
+	else
+	{
+		++str;
+		return utf8_replacement;
+	}
+	if (len > avail)
+	{
+		++str;
+		return utf8_replacement;
+	}
+	for (std::size_t i{1}; i != len; ++i)
+	{
+		if ((s[i] & 0xC0) != 0x80)
+		{
+			++str;
+			return utf8_replacement;
+		}
+		cp = (cp << 6) | (s[i] & 0x3F);
+	}
+	if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+	{
+		++str;
+		return utf8_replacement;
+	}
+	str += len;
+	return cp;
+}
+
+// Display width of a code point as given by wcwidth (-1 for non-printable ones). Results for the Basic
+// Multilingual Plane are cached, offset by 2 so that 0 means "not computed yet".
+inline int code_point_width(char32_t cp)
+{
+	static std::atomic<unsigned char> cache[0x10000];
+	if (cp >= 0x10000)
+		return ::wcwidth(static_cast<wchar_t>(cp));
+	auto cached = cache[cp].load(std::memory_order_relaxed);
+	if (cached == 0)
+	{
+		cached = static_cast<unsigned char>(::wcwidth(static_cast<wchar_t>(cp)) + 2);
+		cache[cp].store(cached, std::memory_order_relaxed);
+	}
+	return cached - 2;
+}
+
+} // namespace internal
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
@@ -0,0 +1,124 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+/**
+ * \file VirtualTerminal.hpp
+ * \brief Header file for the VirtualTerminal class.
+ */
+
+#ifndef NCURSESCPP_VIRTUALTERMINAL_HPP_
+#define NCURSESCPP_VIRTUALTERMINAL_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifndef NCCPP_WINDOW_NOIMPL
+#define NCCPP_WINDOW_NOIMPL
+#include "Window.hpp"
+#undef NCCPP_WINDOW_NOIMPL
+#else
+#include "Window.hpp"
+#endif
+
+namespace nccpp
+{
+
+/**
+ * \brief In-memory terminal ncurses can be bound to instead of the real tty.
+ * 
+ * The terminal is created by use_virtual_terminal() and owned by the Ncurses singleton.
+ * Everything ncurses writes is captured, so the exact bytes emitted for each frame can be inspected.
+ * The screen contents are decoded from *curscr*, the ncurses image of the physical screen.
+ */
+class VirtualTerminal
+{
+	friend class Ncurses;
+	public:
+	VirtualTerminal(int, int, std::string);
+
+	/// \cond NODOC
+	VirtualTerminal(VirtualTerminal const&) = delete;
+	VirtualTerminal& operator=(VirtualTerminal const&) = delete;
+
+	VirtualTerminal(VirtualTerminal&&) = delete;
+	VirtualTerminal& operator=(VirtualTerminal&&) = delete;
+	/// \endcond
+
+	~VirtualTerminal();
+
+	std::string const& get_type() const;
+	int line_count() const;
+	int column_count() const;
+	void resize(int, int);
+
+	std::size_t total_bytes();
+	std::size_t frame_count() const;
+	std::string const& last_frame() const;
+
+	int send_input(std::string const&);
+
+	chtype cell(int, int) const;
+	String row(int) const;
+
+	private:
+	std::string type_;
+	int lines_;
+	int cols_;
+	int out_pipe_[2];
+	int in_pipe_[2];
+	std::FILE* out_file_;
+	std::FILE* in_file_;
+
+	std::mutex mutex_;
+	std::string pending_;
+	std::string last_frame_;
+	std::size_t total_;
+	std::size_t frames_;
+	std::thread drain_thread_;
+
+	void drain_();
+	bool read_available_();
+	void end_frame_();
+	void close_();
+};
+
+} // namespace nccpp
+
+#include "VirtualTerminal.ipp"
+
+#endif // Header guard
@@ -0,0 +1,294 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+#ifndef NCURSESCPP_VIRTUALTERMINAL_IPP_
+#define NCURSESCPP_VIRTUALTERMINAL_IPP_
+
+#include <cassert>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "errors.hpp"
+
+namespace nccpp
+{
+
+/**
+ * \brief Create a virtual terminal.
+ * 
+ * Use use_virtual_terminal() to bind ncurses to a virtual terminal.
+ * 
+ * \param lines,cols Size of the terminal.
+ * \param type Terminal type, as in the TERM environment variable.
+ * \exception errors::TerminalInit Thrown if the terminal can't be created.
+ */
+inline VirtualTerminal::VirtualTerminal(int lines, int cols, std::string type)
+	: type_{std::move(type)}, lines_{lines}, cols_{cols}, out_pipe_{-1, -1}, in_pipe_{-1, -1},
+	  out_file_{nullptr}, in_file_{nullptr}, mutex_{}, pending_{}, last_frame_{}, total_{0},
+	  frames_{0}, drain_thread_{}
+{
+	if (pipe(out_pipe_) == -1 || pipe(in_pipe_) == -1 ||
+	    fcntl(out_pipe_[0], F_SETFL, fcntl(out_pipe_[0], F_GETFL) | O_NONBLOCK) == -1 ||
+	    fcntl(in_pipe_[1], F_SETFL, fcntl(in_pipe_[1], F_GETFL) | O_NONBLOCK) == -1 ||
+	    !(out_file_ = fdopen(out_pipe_[1], "w")) || !(in_file_ = fdopen(in_pipe_[0], "r")))
+	{
+		close_();
+		throw errors::TerminalInit{};
+	}
+#ifdef F_SETPIPE_SZ
+	// Fewer wake-ups of the drain thread for large frames, failure is harmless
+	fcntl(out_pipe_[1], F_SETPIPE_SZ, 1 << 20);
+#endif
+	try
+	{
+		drain_thread_ = std::thread{[this]{drain_();}};
+	}
+	catch (...)
+	{
+		close_();
+		throw errors::TerminalInit{};
+	}
+}
+
+inline VirtualTerminal::~VirtualTerminal()
+{
+	// The drain thread sleeps until the pipe is readable, closing the write end wakes it up for good
+	std::fclose(out_file_);
+	out_file_ = nullptr;
+	out_pipe_[1] = -1;
+	drain_thread_.join();
+	close_();
+}
+
+/**
+ * \brief Get the terminal type.
+ * 
+ * \return The terminal type.
+ */
+inline std::string const& VirtualTerminal::get_type() const
+{
+	return type_;
+}
+
+/**
+ * \brief Get the height of the terminal.
+ * 
+ * \return The number of lines of the terminal.
+ */
+inline int VirtualTerminal::line_count() const
+{
+	return lines_;
+}
+
+/**
+ * \brief Get the width of the terminal.
+ * 
+ * \return The number of columns of the terminal.
+ */
+inline int VirtualTerminal::column_count() const
+{
+	return cols_;
+}
+
+/**
+ * \brief Change the size of the terminal, as if it was resized by the user.
+ * 
+ * As with a real terminal, ncurses isn't told: the size is picked up by
+ * Ncurses::update_terminal_size(). Queue KEY_RESIZE with Ncurses::ungetch() to simulate SIGWINCH.
+ * 
+ * \param lines,cols New size.
+ */
+inline void VirtualTerminal::resize(int lines, int cols)
+{
+	lines_ = lines;
+	cols_ = cols;
+}
+
+/**
+ * \brief Get the number of bytes written by ncurses since the creation of the terminal.
+ * 
+ * \return The number of bytes.
+ */
+inline std::size_t VirtualTerminal::total_bytes()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	read_available_();
+	return total_;
+}
+
+/**
+ * \brief Get the number of frames sent to the terminal.
+ * 
+ * A frame ends with each call to Ncurses::doupdate() or Window::refresh().
+ * 
+ * \return The number of frames.
+ */
+inline std::size_t VirtualTerminal::frame_count() const
+{
+	return frames_;
+}
+
+/**
+ * \brief Get the bytes of the last frame.
+ * 
+ * The first frame also contains the initialization sequences sent by ncurses.
+ * 
+ * \return The bytes written by ncurses between the end of the previous frame and the end of the last one.
+ */
+inline std::string const& VirtualTerminal::last_frame() const
+{
+	return last_frame_;
+}
+
+/**
+ * \brief Send input to ncurses, as if it were typed on the terminal.
+ * 
+ * The input is buffered in a pipe until ncurses reads it. This function never blocks : if the pipe is
+ * full, ERR is returned. An input of at most PIPE_BUF bytes is then not sent at all, a larger one may
+ * have been partly sent.
+ * 
+ * \param input The bytes to send.
+ * \return OK, or ERR if the input couldn't be sent entirely.
+ */
+inline int VirtualTerminal::send_input(std::string const& input)
+{
+	std::size_t done{0};
+	while (done != input.size())
+	{
+		auto n = write(in_pipe_[1], input.data() + done, input.size() - done);
+		if (n == -1 && errno != EINTR)
+			return ERR;
+		if (n > 0)
+			done += static_cast<std::size_t>(n);
+	}
+	return OK;
+}
+
+/**
+ * \brief Get a cell of the screen, as displayed after the last frame.
+ * 
+ * \param y,x Position of the cell.
+ * \pre %Ncurses is bound to this terminal.
+ * \return The character and attributes of the cell.
+ */
+inline chtype VirtualTerminal::cell(int y, int x) const
+{
+	assert(curscr && "Ncurses isn't bound to the terminal");
+	int cur_y{0}, cur_x{0};
+	getyx(curscr, cur_y, cur_x);
+	auto ch = mvwinch(curscr, y, x);
+	wmove(curscr, cur_y, cur_x);
+	return ch;
+}
+
+/**
+ * \brief Get a line of the screen, as displayed after the last frame.
+ * 
+ * \param y Index of the line.
+ * \pre %Ncurses is bound to this terminal.
+ * \return The characters and attributes of the line.
+ */
+inline String VirtualTerminal::row(int y) const
+{
+	assert(curscr && "Ncurses isn't bound to the terminal");
+	String res(static_cast<std::size_t>(cols_) + 1, 0);
+	int cur_y{0}, cur_x{0};
+	getyx(curscr, cur_y, cur_x);
+	auto n = mvwinchnstr(curscr, y, 0, &res[0], cols_);
+	wmove(curscr, cur_y, cur_x);
+	res.resize(n == ERR ? 0 : static_cast<std::size_t>(n));
+	return res;
+}
+
+inline void VirtualTerminal::drain_()
+{
+	pollfd pfd{out_pipe_[0], POLLIN, 0};
+	for (;;)
+	{
+		if (poll(&pfd, 1, -1) <= 0)
+			continue;
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (!read_available_())
+			return; // The write end is closed, the terminal is being destroyed
+	}
+}
+
+inline bool VirtualTerminal::read_available_()
+{
+	char buf[1 << 14];
+	ssize_t n{0};
+	while ((n = read(out_pipe_[0], buf, sizeof buf)) > 0 || (n == -1 && errno == EINTR))
+	{
+		if (n > 0)
+		{
+			pending_.append(buf, static_cast<std::size_t>(n));
+			total_ += static_cast<std::size_t>(n);
+		}
+	}
+	return n != 0;
+}
+
+inline void VirtualTerminal::end_frame_()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	// ncurses has returned, so every byte of the frame is already in the pipe
+	read_available_();
+	last_frame_.swap(pending_);
+	pending_.clear();
+	++frames_;
+}
+
+inline void VirtualTerminal::close_()
+{
+	if (out_file_)
+		std::fclose(out_file_);
+	else if (out_pipe_[1] != -1)
+		::close(out_pipe_[1]);
+	if (in_file_)
+		std::fclose(in_file_);
+	else if (in_pipe_[0] != -1)
+		::close(in_pipe_[0]);
+	if (out_pipe_[0] != -1)
+		::close(out_pipe_[0]);
+	if (in_pipe_[1] != -1)
+		::close(in_pipe_[1]);
+}
+
+} // namespace nccpp
+
+#endif // Header guard
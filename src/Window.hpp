@@ -41,15 +41,39 @@
 #ifndef NCURSESCPP_WINDOW_HPP_
 #define NCURSESCPP_WINDOW_HPP_
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+/// \cond NODOC
+#if __cplusplus >= 201703L
+#include <string_view>
+#define NCCPP_HAS_STRING_VIEW
+#endif
+
+#if __cplusplus >= 202002L
+#include <span>
+#define NCCPP_HAS_SPAN
+#endif
+/// \endcond
+
 #ifndef NCURSES_NOMACROS
 #define NCURSES_NOMACROS
 #endif
 
+#ifndef NCURSES_WIDECHAR
+#define NCURSES_WIDECHAR 1
+#endif
+
 #include <ncurses.h>
 
+#include "Event.hpp"
+#include "Format.hpp"
+#include "Instrumentation.hpp"
+#include "SlotMap.hpp"
+#include "Style.hpp"
+#include "Utf8.hpp"
+
 namespace nccpp
 {
 
@@ -59,7 +83,66 @@ using String = std::basic_string<chtype>;
 struct Color;
 
 class Ncurses;
+class Screen;
+class Window;
 class Subwindow;
+class Pad;
+
+/** \brief Handle to a subwindow, returned by Window::add_subwindow. */
+using SubwindowHandle = Handle<Subwindow>;
+
+/// \cond NODOC
+namespace internal
+{
+
+// Location of the code which created a window, reported by Screen::dump_live_windows
+struct SourceSite
+{
+	char const* file;
+	int line;
+
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+	static SourceSite current(char const* file = __builtin_FILE(), int line = __builtin_LINE())
+	{
+		return SourceSite{file, line};
+	}
+#else
+	static SourceSite current()
+	{
+		return SourceSite{nullptr, 0};
+	}
+#endif
+};
+
+// Links of the debug window registry, kept in each window so that registering is O(1)
+struct RegistryLink
+{
+	Window* prev;
+	Window* next;
+	Screen* screen;
+	SourceSite site;
+};
+
+struct SnapshotHeader;
+
+} // namespace internal
+
+// Windows are registered in their Screen in debug mode, to check their use, and when instrumented
+#if !defined(NDEBUG) || defined(NCCPP_INSTRUMENTATION)
+#define NCCPP_WINDOW_REGISTRY
+#endif
+
+// When registered, the functions creating windows take the location of their caller
+#ifdef NCCPP_WINDOW_REGISTRY
+#define NCCPP_SITE_PARAM , ::nccpp::internal::SourceSite = ::nccpp::internal::SourceSite::current()
+#define NCCPP_SITE_DEF , ::nccpp::internal::SourceSite site
+#define NCCPP_SITE_FWD , site
+#else
+#define NCCPP_SITE_PARAM
+#define NCCPP_SITE_DEF
+#define NCCPP_SITE_FWD
+#endif
+/// \endcond
 
 /**
  * \brief Class managing a ncurses window.
@@ -67,17 +150,13 @@ class Subwindow;
 class Window
 {
 	public:
-	explicit Window(WINDOW*);
-	Window(int, int, int, int);
+	explicit Window(WINDOW* NCCPP_SITE_PARAM);
+	Window(int, int, int, int NCCPP_SITE_PARAM);
 
-	Window(Window const&);
+	Window(Window const& NCCPP_SITE_PARAM);
 	Window& operator=(Window const&);
 
-	Window(Window&&)
-#ifdef NDEBUG
-		noexcept
-#endif
-		;
+	Window(Window&&) noexcept;
 	Window& operator=(Window&&)noexcept;
 
 	/// \cond NODOC
@@ -90,6 +169,11 @@ class Window
 	Window& operator=(Subwindow const&) = delete;
 	Window(Subwindow&&) = delete;
 	Window& operator=(Subwindow&&) = delete;
+
+	Window(Pad const&) = delete;
+	Window& operator=(Pad const&) = delete;
+	Window(Pad&&) = delete;
+	Window& operator=(Pad&&) = delete;
 	/// \endcond
 
 	~Window();
@@ -98,10 +182,13 @@ class Window
 	virtual void destroy();
 	WINDOW* get_handle();
 	WINDOW const* get_handle() const;
+	Screen& get_owning_screen();
 
-	std::size_t add_subwindow(int, int, int, int);
-	Subwindow& get_subwindow(std::size_t);
-	void delete_subwindow(std::size_t);
+	SubwindowHandle add_subwindow(int, int, int, int NCCPP_SITE_PARAM);
+	bool has_subwindow(SubwindowHandle) const;
+	Subwindow& get_subwindow(SubwindowHandle);
+	void delete_subwindow(SubwindowHandle);
+	void compact_subwindows();
 
 	// Input options
 
@@ -133,13 +220,24 @@ class Window
 
 	int instr(std::string&);
 	int innstr(std::string&, std::size_t);
+	int innstr(char*, std::size_t);
 	int mvinstr(int, int, std::string&);
 	int mvinnstr(int, int, std::string&, std::size_t);
+	int mvinnstr(int, int, char*, std::size_t);
 
 	int inchstr(String&);
 	int inchnstr(String&, std::size_t);
+	int inchnstr(chtype*, std::size_t);
 	int mvinchstr(int, int, String&);
 	int mvinchnstr(int, int, String&, std::size_t);
+	int mvinchnstr(int, int, chtype*, std::size_t);
+
+	std::size_t read_events(Event*, std::size_t);
+	template <std::size_t N>
+	std::size_t read_events(Event (&)[N]);
+#ifdef NCCPP_HAS_SPAN
+	std::size_t read_events(std::span<Event>);
+#endif
 
 	// Output functions
 
@@ -147,26 +245,78 @@ class Window
 	int mvaddch(int, int, chtype const);
 	int echochar(chtype const);
 
-	int printw(char const*, ...);
-	int mvprintw(int, int, char const*, ...);
+	int printw(internal::VarargsFormat, ...);
+	int mvprintw(int, int, internal::VarargsFormat, ...);
+	template <typename... Args>
+	typename std::enable_if<internal::IsFormattable<Args...>::value, int>::type
+	printw(FormatString<typename internal::Identity<Args>::type...>, Args const&...);
+	template <typename... Args>
+	typename std::enable_if<internal::IsFormattable<Args...>::value, int>::type
+	mvprintw(int, int, FormatString<typename internal::Identity<Args>::type...>, Args const&...);
 
 	int addstr(std::string const&);
+	int addstr(char const*);
 	int addnstr(std::string const&, std::size_t);
+	int addnstr(char const*, std::size_t);
 	int mvaddstr(int, int, std::string const&);
+	int mvaddstr(int, int, char const*);
 	int mvaddnstr(int, int, std::string const&, std::size_t);
+	int mvaddnstr(int, int, char const*, std::size_t);
 
 	int addchstr(String const&);
+	int addchstr(chtype const*);
 	int addchnstr(String const&, std::size_t);
+	int addchnstr(chtype const*, std::size_t);
 	int mvaddchstr(int, int, String const&);
+	int mvaddchstr(int, int, chtype const*);
 	int mvaddchnstr(int, int, String const&, std::size_t);
+	int mvaddchnstr(int, int, chtype const*, std::size_t);
 
 	int insch(chtype);
 	int mvinsch(int y, int x, chtype);
 
 	int insstr(std::string const&);
+	int insstr(char const*);
 	int insnstr(std::string const&, std::size_t);
+	int insnstr(char const*, std::size_t);
 	int mvinsstr(int, int, std::string const&);
+	int mvinsstr(int, int, char const*);
 	int mvinsnstr(int, int, std::string const&, std::size_t);
+	int mvinsnstr(int, int, char const*, std::size_t);
+
+#ifdef NCCPP_HAS_STRING_VIEW
+	int addstr(std::string_view);
+	int mvaddstr(int, int, std::string_view);
+	int insstr(std::string_view);
+	int mvinsstr(int, int, std::string_view);
+#endif
+
+#ifdef NCCPP_HAS_SPAN
+	int addchstr(std::span<chtype const>);
+	int mvaddchstr(int, int, std::span<chtype const>);
+#endif
+
+	int blit(int, int, int, int, chtype const*, std::size_t);
+	int blit(int, int, int, int, chtype const*, std::size_t, chtype);
+
+	int add_utf8(std::string const&);
+	int add_utf8(char const*);
+	int add_utf8(char const*, std::size_t);
+	int mvadd_utf8(int, int, std::string const&);
+	int mvadd_utf8(int, int, char const*);
+	int mvadd_utf8(int, int, char const*, std::size_t);
+#ifdef NCCPP_HAS_STRING_VIEW
+	int add_utf8(std::string_view);
+	int mvadd_utf8(int, int, std::string_view);
+#endif
+
+	int add_runs(StyledRun const*, std::size_t);
+	template <std::size_t N>
+	int add_runs(StyledRun const (&)[N]);
+	int mvadd_runs(int, int, StyledRun const*, std::size_t);
+#ifdef NCCPP_HAS_SPAN
+	int add_runs(std::span<StyledRun const>);
+#endif
 
 	// Deletion functions
 
@@ -196,27 +346,32 @@ class Window
 	int attroff(int);
 	int attron(int);
 	int attrset(int);
+	int attr_set(Style const&);
 
 	int attr_get(attr_t&);
+	int attr_get(Style&);
 	int color_get(Color&);
 
 	int attr_color_get(attr_t&, Color&);
 
 	int chgat(int, attr_t, Color);
+	int chgat(int, Style const&);
 	int mvchgat(int, int, int, attr_t, Color);
+	int mvchgat(int, int, int, Style const&);
 
 	// Misc
 
 	int move(int, int);
 	int mvwin(int, int);
+	int resize(int, int);
 	
 	int erase();
 	int clear();
 	int clrtobot();
 	int clrtoeol();
 
-	int refresh();
-	int outrefresh();
+	virtual int refresh();
+	virtual int outrefresh();
 	int redraw();
 	int redrawln(int, int);
 
@@ -231,10 +386,27 @@ class Window
 	bool enclose(int, int);
 	bool coord_trafo(int&, int&, bool);
 
+	// Snapshots
+
+	int save(char const*);
+	int save(std::string const&);
+	int save(char const*, char const*);
+	int save(std::string const&, std::string const&);
+	int load(char const*);
+	int load(std::string const&);
+
+#ifdef NCCPP_INSTRUMENTATION
+	// Instrumentation
+
+	WindowRenderStats window_render_stats() const;
+#endif
+
 	protected:
 	/// \cond NODOC
 	struct Key{};
 
+	// Screen current when the window was created, on which it's refreshed and cancelled
+	Screen* owning_screen_;
 	WINDOW* win_;
 	/// \endcond
 
@@ -247,8 +419,38 @@ class Window
 	/// \endcond
 #endif
 
+#ifdef NCCPP_WINDOW_REGISTRY
 	private:
-	std::vector<Subwindow> subwindows_;
+	/// \cond NODOC
+	// Screen links its windows through registry_ and gathers their counters
+	friend class Screen;
+
+	internal::RegistryLink registry_;
+	WINDOW* debug_handle_() const;
+	/// \endcond
+#endif
+#ifdef NCCPP_INSTRUMENTATION
+	private:
+	/// \cond NODOC
+	friend WindowRenderStats& internal::render_stats_of(Window&);
+
+	WindowRenderStats instrumentation_;
+	/// \endcond
+#endif
+
+	private:
+	/// \cond NODOC
+	bool clip_rect_(int&, int&, int&, int&, chtype const*&, std::size_t);
+	int add_ascii_run_(int, int&, int, char const*, std::size_t, chtype);
+	int add_wide_run_(int, int&, int, char const*&, char const*, attr_t, short, bool);
+	void read_snapshot_(internal::SnapshotHeader&, std::vector<cchar_t>&);
+	int write_snapshot_cells_(int, int, int, int, cchar_t const*, std::size_t);
+#ifdef NCCPP_WINDOW_REGISTRY
+	void move_registration_(Screen*);
+#endif
+	/// \endcond
+
+	internal::SlotMap<Subwindow> subwindows_;
 };
 
 } // namespace nccpp
@@ -46,16 +46,25 @@ namespace nccpp
  * 
  * \param win The ncurses window. If win is nullptr, the Window created doesn't manage anything.
  */
-inline Window::Window(WINDOW* win)
-	: win_{win},
+inline Window::Window(WINDOW* win NCCPP_SITE_DEF)
+	: owning_screen_{internal::current_screen_ptr()}, win_{win},
 #ifndef NDEBUG
 	  win_save_{nullptr},
+#endif
+#ifdef NCCPP_WINDOW_REGISTRY
+	  registry_{nullptr, nullptr, nullptr, site},
+#endif
+#ifdef NCCPP_INSTRUMENTATION
+	  instrumentation_{},
 #endif
 	  subwindows_{}
 {
-#ifndef NDEBUG
+#ifdef NCCPP_WINDOW_REGISTRY
 	if (win_ != stdscr)
-		ncurses().register_window_(*this, Key{});
+	{
+		owning_screen_ = &internal::current_screen();
+		owning_screen_->register_window_(*this, Key{});
+	}
 #endif
 }
 
@@ -69,25 +78,24 @@ inline Window::Window(WINDOW* win)
  * \pre %Ncurses mode is on.
  * \exception errors::WindowInit Thrown if the window can't be created.
  */
-inline Window::Window(int nlines, int ncols, int begin_y, int begin_x)
-	: win_{ncurses().newwin_(nlines, ncols, begin_y, begin_x, Key{})},
+inline Window::Window(int nlines, int ncols, int begin_y, int begin_x NCCPP_SITE_DEF)
+	: owning_screen_{&internal::current_screen()},
+	  win_{owning_screen_->newwin_(nlines, ncols, begin_y, begin_x, Key{})},
 #ifndef NDEBUG
 	  win_save_{nullptr},
+#endif
+#ifdef NCCPP_WINDOW_REGISTRY
+	  registry_{nullptr, nullptr, nullptr, site},
+#endif
+#ifdef NCCPP_INSTRUMENTATION
+	  instrumentation_{},
 #endif
 	  subwindows_{}
 {
 	if (!win_)
 		throw errors::WindowInit{};
-#ifndef NDEBUG
-	try
-	{
-		ncurses().register_window_(*this, Key{});
-	}
-	catch (...)
-	{
-		delwin(win_);
-		throw;
-	}
+#ifdef NCCPP_WINDOW_REGISTRY
+	owning_screen_->register_window_(*this, Key{});
 #endif
 }
 
@@ -99,27 +107,27 @@ inline Window::Window(int nlines, int ncols, int begin_y, int begin_x)
  * \pre %Ncurses mode is on.
  * \exception errors::WindowInit Thrown if the window can't be duplicated.
  */
-inline Window::Window(Window const& cp)
-	: win_{nullptr},
+inline Window::Window(Window const& cp NCCPP_SITE_DEF)
+	: owning_screen_{cp.owning_screen_}, win_{nullptr},
 #ifndef NDEBUG
 	  win_save_{nullptr},
+#endif
+#ifdef NCCPP_WINDOW_REGISTRY
+	  registry_{nullptr, nullptr, nullptr, site},
+#endif
+#ifdef NCCPP_INSTRUMENTATION
+	  instrumentation_{},
 #endif
 	  subwindows_{}
 {
 	assert(!cp.win_save_ && "Can't duplicate windows while ncurses mode is off");
-	subwindows_.reserve(cp.subwindows_.size());
 	if (cp.win_ && !(win_ = dupwin(cp.win_)))
 		throw errors::WindowInit{};
-#ifndef NDEBUG
-	try
-	{
-		ncurses().register_window_(*this, Key{});
-	}
-	catch (...)
-	{
-		delwin(win_);
-		throw;
-	}
+#ifdef NCCPP_WINDOW_REGISTRY
+	// dupwin creates the copy on the screen of cp
+	if (!owning_screen_)
+		owning_screen_ = &internal::current_screen();
+	owning_screen_->register_window_(*this, Key{});
 #endif
 }
 
@@ -145,20 +153,25 @@ inline Window& Window::operator=(Window const& cp)
 /**
  * \brief Move constructor.
  */
-inline Window::Window(Window&& mv)
-#ifdef NDEBUG
-	noexcept
-#endif
-	: win_{mv.win_},
+inline Window::Window(Window&& mv) noexcept
+	: owning_screen_{mv.owning_screen_}, win_{mv.win_},
 #ifndef NDEBUG
 	  win_save_{mv.win_save_},
+#endif
+#ifdef NCCPP_WINDOW_REGISTRY
+	  registry_{nullptr, nullptr, nullptr, mv.registry_.site},
+#endif
+#ifdef NCCPP_INSTRUMENTATION
+	  instrumentation_(mv.instrumentation_),
 #endif
 	  subwindows_{std::move(mv.subwindows_)}
 {
 	mv.win_ = nullptr;
 #ifndef NDEBUG
 	mv.win_save_ = nullptr;
-	ncurses().register_window_(*this, Key{});
+#endif
+#ifdef NCCPP_WINDOW_REGISTRY
+	(mv.registry_.screen ? *mv.registry_.screen : internal::current_screen()).register_window_(*this, Key{});
 #endif
 }
 
@@ -170,11 +183,18 @@ inline Window& Window::operator=(Window&& mv) noexcept
 	if (this != &mv)
 	{
 		destroy();
+		owning_screen_ = mv.owning_screen_;
+#ifdef NCCPP_WINDOW_REGISTRY
+		(this->move_registration_)(mv.registry_.screen);
+#endif
 		win_ = mv.win_;
 		mv.win_ = nullptr;
 #ifndef NDEBUG
 		win_save_ = mv.win_save_;
 		mv.win_save_ = nullptr;
+#endif
+#ifdef NCCPP_INSTRUMENTATION
+		instrumentation_ = mv.instrumentation_;
 #endif
 		subwindows_ = std::move(mv.subwindows_);
 	}
@@ -186,9 +206,9 @@ inline Window& Window::operator=(Window&& mv) noexcept
  */
 inline Window::~Window()
 {
-#ifndef NDEBUG
-	if (this != &ncurses())
-		ncurses().unregister_window_(*this, Key{});
+#ifdef NCCPP_WINDOW_REGISTRY
+	if (registry_.screen)
+		registry_.screen->unregister_window_(*this, Key{});
 #endif
 	destroy();
 }
@@ -207,6 +227,13 @@ inline void Window::assign(WINDOW* new_win)
 	if (win_)
 		destroy();
 	win_ = new_win;
+	if (new_win)
+	{
+		owning_screen_ = internal::current_screen_ptr();
+#ifdef NCCPP_WINDOW_REGISTRY
+		(this->move_registration_)(&internal::current_screen());
+#endif
+	}
 }
 
 /**
@@ -217,6 +244,8 @@ inline void Window::destroy()
 	if (win_)
 	{
 		subwindows_.clear();
+		if (owning_screen_)
+			owning_screen_->get_frame_scheduler().cancel(*this);
 		delwin(win_);
 		win_ = nullptr;
 	}
@@ -230,6 +259,17 @@ inline void Window::destroy()
 #endif
 }
 
+/**
+ * \brief Get the screen the window belongs to.
+ * 
+ * \return The screen which was current when the window was created, or the current screen if there
+ * was none.
+ */
+inline Screen& Window::get_owning_screen()
+{
+	return owning_screen_ ? *owning_screen_ : internal::current_screen();
+}
+
 /**
  * \brief Get the managed window.
  * 
@@ -257,13 +297,15 @@ inline WINDOW const* Window::get_handle() const
 /**
  * \brief Create a new subwindow.
  * 
+ * The slot of a deleted subwindow is reused if there is one.
+ * 
  * \param lines,cols,beg_y,beg_x Values to pass on to subwin.
  * \pre The Window manages a ncurses window.
  * \pre The function parameters are valid subwindow coodinates.
  * \exception errors::WindowInit Thrown if the subwindow can't be created.
- * \return The subwindow index.
+ * \return A handle to the subwindow.
  */
-inline std::size_t Window::add_subwindow(int lines, int cols, int beg_y, int beg_x)
+inline SubwindowHandle Window::add_subwindow(int lines, int cols, int beg_y, int beg_x NCCPP_SITE_DEF)
 {
 	assert(win_ && "Window doesn't manage any object");
 #ifndef NDEBUG
@@ -279,62 +321,133 @@ inline std::size_t Window::add_subwindow(int lines, int cols, int beg_y, int beg
 		throw errors::WindowInit{};
 	try
 	{
-		subwindows_.emplace_back(*this, new_subw, Window::Key{});
+		return subwindows_.emplace(*this, new_subw, Window::Key{} NCCPP_SITE_FWD);
 	}
 	catch (...)
 	{
 		delwin(new_subw);
 		throw;
 	}
-	return subwindows_.size() - 1;
+}
+
+/**
+ * \brief Check whether a handle refers to an existing subwindow of this window.
+ * 
+ * \param handle Handle to check.
+ * \return false if the subwindow has been deleted, true otherwise.
+ */
+inline bool Window::has_subwindow(SubwindowHandle handle) const
+{
+	return subwindows_.contains(handle);
 }
 
 /**
  * \brief Get an existing subwindow.
  * 
- * \param index Index of the subwindow.
+ * The reference stays valid until the subwindow is deleted.
+ * 
+ * \param handle Handle to the subwindow.
  * \pre The Window manages a ncurses window.
- * \pre *index* is a valid subwindow index.
+ * \pre *handle* refers to an existing subwindow.
  * \return The subwindow.
  */
-inline Subwindow& Window::get_subwindow(std::size_t index)
+inline Subwindow& Window::get_subwindow(SubwindowHandle handle)
 {
 	assert(win_ && "Window doesn't manage any object");
-	assert(index < subwindows_.size() && subwindows_[index].win_ && "Invalid subwindow");
-	return subwindows_[index];
+	assert(subwindows_.contains(handle) && "Invalid subwindow");
+	return subwindows_.get(handle);
 }
 
 /**
  * \brief Destroy a subwindow.
  * 
- * References obtained by calling get_subwindow(index) shouldn't be used after calling this function.
- * References to other subwindows are not invalidated.
+ * References obtained by calling get_subwindow(handle) shouldn't be used after calling this function,
+ * and *handle* becomes stale. Other subwindows aren't affected.
  * 
- * \param index Index of the subwindow.
+ * \param handle Handle to the subwindow.
  * \pre The Window manages a ncurses window.
- * \pre *index* is a valid subwindow index.
+ * \pre *handle* refers to an existing subwindow.
  */
-inline void Window::delete_subwindow(std::size_t index)
+inline void Window::delete_subwindow(SubwindowHandle handle)
 {
 	assert(win_ && "Window doesn't manage any object");
-	assert(index < subwindows_.size() && subwindows_[index].win_ && "Invalid subwindow");
-	subwindows_[index].~Subwindow();
-	new (&subwindows_[index]) Subwindow{*this, nullptr, Key{}};
+	assert(subwindows_.contains(handle) && "Invalid subwindow");
+	subwindows_.erase(handle);
+}
+
+/**
+ * \brief Release the memory held by the slots of deleted subwindows, when possible.
+ * 
+ * Subwindows are never moved, so only the unused slots following the last existing subwindow can be
+ * released. Handles to existing subwindows stay valid, and stale handles are still detected.
+ */
+inline void Window::compact_subwindows()
+{
+	subwindows_.compact();
+}
+
+#ifdef NCCPP_INSTRUMENTATION
+/**
+ * \brief Get the rendering counters of this window.
+ * 
+ * The memory isn't computed, see Screen::render_stats for it. Only available when
+ * NCCPP_INSTRUMENTATION is defined.
+ * 
+ * \return The counters accumulated since the creation of the window or the last
+ * Screen::reset_render_stats.
+ */
+inline WindowRenderStats Window::window_render_stats() const
+{
+	auto stats = instrumentation_;
+	stats.window = this;
+	return stats;
+}
+
+/// \cond NODOC
+namespace internal
+{
+
+inline WindowRenderStats& render_stats_of(Window& win)
+{
+	return win.instrumentation_;
+}
+
+} // namespace internal
+/// \endcond
+#endif
+
+#ifdef NCCPP_WINDOW_REGISTRY
+inline WINDOW* Window::debug_handle_() const
+{
+#ifndef NDEBUG
+	return win_ ? win_ : win_save_;
+#else
+	return win_;
+#endif
 }
 
+// Keep the window in the registry of the screen it belongs to
+inline void Window::move_registration_(Screen* screen)
+{
+	if (registry_.screen == screen)
+		return;
+	if (registry_.screen)
+		registry_.screen->unregister_window_(*this, Key{});
+	if (screen)
+		screen->register_window_(*this, Key{});
+}
+#endif
+
 #ifndef NDEBUG
+// Subwindows are registered too, so Ncurses reaches them directly
 inline void Window::invalidate_for_exit_(Window::Key /*dummy*/)
 {
-	for (auto& elem : subwindows_)
-		elem.invalidate_for_exit_(Key{});
 	win_save_ = win_;
 	win_ = nullptr;
 }
 
 inline void Window::validate_for_resume_(Window::Key /*dummy*/)
 {
-	for (auto& elem : subwindows_)
-		elem.validate_for_resume_(Key{});
 	win_ = win_save_;
 	win_save_ = nullptr;
 }
@@ -384,5 +497,6 @@ inline int copywin(Window const& src, Window& dst,
 #include "Window_misc.ipp"
 #include "Window_options.ipp"
 #include "Window_output.ipp"
+#include "Window_snapshot.ipp"
 
 #endif // Header guard
@@ -50,6 +50,7 @@ inline int Window::border(chtype ls, chtype rs, chtype ts, chtype bs,
                      chtype tl, chtype tr, chtype bl, chtype br)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, lines, static_cast<std::size_t>(2 * (getmaxy(win_) + getmaxx(win_)) - 4));
 	return wborder(win_, ls, rs, ts, bs, tl, tr, bl, br);
 }
 
@@ -63,6 +64,7 @@ inline int Window::border(chtype ls, chtype rs, chtype ts, chtype bs,
 inline int Window::box(chtype vch, chtype hch)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, lines, static_cast<std::size_t>(2 * (getmaxy(win_) + getmaxx(win_)) - 4));
 	return ::box(win_, vch, hch);
 }
 
@@ -76,6 +78,7 @@ inline int Window::box(chtype vch, chtype hch)
 inline int Window::hline(chtype ch, int n)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, lines, static_cast<std::size_t>(std::max(n, 0)));
 	return whline(win_, ch, n);
 }
 
@@ -89,6 +92,7 @@ inline int Window::hline(chtype ch, int n)
 inline int Window::vline(chtype ch, int n)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, lines, static_cast<std::size_t>(std::max(n, 0)));
 	return wvline(win_, ch, n);
 }
 
@@ -80,6 +80,19 @@ inline int Window::attrset(int a)
 	return wattrset(win_, a);
 }
 
+/**
+ * \brief Call wattr_set for this window.
+ * 
+ * \param s The style to set. Its pair is used as is, without looking up any color.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::attr_set(Style const& s)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return wattr_set(win_, s.attributes(), s.pair_number(), nullptr);
+}
+
 /**
  * \brief Get the attributes of the window.
  * 
@@ -93,6 +106,26 @@ inline int Window::attr_get(attr_t& a)
 	return wattr_get(win_, &a, nullptr, nullptr);
 }
 
+/**
+ * \brief Get the attributes and the pair of the window as a style.
+ * 
+ * Unlike color_get(), the pair number isn't converted back to a color.
+ * 
+ * \param[out] s Reference to store the style.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::attr_get(Style& s)
+{
+	assert(win_ && "Window doesn't manage any object");
+	attr_t a{A_NORMAL};
+	short pair_n{0};
+	if (wattr_get(win_, &a, &pair_n, nullptr) == ERR)
+		return ERR;
+	s = Style{a, pair_n};
+	return OK;
+}
+
 /**
  * \brief Get the color of the window.
  * 
@@ -106,7 +139,7 @@ inline int Window::color_get(Color& c)
 	short pair_n{0};
 	if (wattr_get(win_, nullptr, &pair_n, nullptr) == ERR)
 		return ERR;
-	c = nccpp::ncurses().pair_number_to_color(pair_n);
+	c = (this->get_owning_screen)().pair_number_to_color(pair_n);
 	return OK;
 }
 
@@ -124,7 +157,7 @@ inline int Window::attr_color_get(attr_t& a, Color& c)
 	short pair_n{0};
 	if (wattr_get(win_, &a, &pair_n, nullptr) == ERR)
 		return ERR;
-	c = nccpp::ncurses().pair_number_to_color(pair_n);
+	c = (this->get_owning_screen)().pair_number_to_color(pair_n);
 	return OK;
 }
 
@@ -137,7 +170,22 @@ inline int Window::attr_color_get(attr_t& a, Color& c)
 inline int Window::chgat(int n, attr_t a, Color c)
 {
 	assert(win_ && "Window doesn't manage any object");
-	return ::wchgat(win_, n, a, nccpp::ncurses().color_to_pair_number(c), nullptr);
+	NCCPP_RECORD_OUTPUT(*this, chgat, static_cast<std::size_t>(n < 0 ? getmaxx(win_) - getcurx(win_) : n));
+	return ::wchgat(win_, n, a, (this->get_owning_screen)().color_to_pair_number(c), nullptr);
+}
+
+/**
+ * \brief Call wchgat for this window with a precomputed style.
+ * \param n Value to pass on to wchgat.
+ * \param s The style to apply. Its pair is used as is, without looking up any color.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::chgat(int n, Style const& s)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, chgat, static_cast<std::size_t>(n < 0 ? getmaxx(win_) - getcurx(win_) : n));
+	return ::wchgat(win_, n, s.attributes(), s.pair_number(), nullptr);
 }
 
 /**
@@ -152,6 +200,19 @@ inline int Window::mvchgat(int y, int x, int n, attr_t a, Color c)
 	return (this->move)(y, x) == ERR ? ERR : (this->chgat)(n, a, c);
 }
 
+/**
+ * \brief Call mvwchgat for this window with a precomputed style.
+ * \param y,x,n Values to pass on to mvwchgat.
+ * \param s The style to apply.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::mvchgat(int y, int x, int n, Style const& s)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return (this->move)(y, x) == ERR ? ERR : (this->chgat)(n, s);
+}
+
 } // namespace nccpp
 
 #endif // Header guard
@@ -222,6 +222,23 @@ inline int Window::innstr(std::string& str, std::size_t n)
 	return winnstr(win_, &str[0], static_cast<int>(n));
 }
 
+/**
+ * \brief Call winnstr for this window.
+ * 
+ * No allocation is performed, the caller owns the buffer.
+ * 
+ * \param[out] str The resulting null-terminated string.
+ * \param n Number of characters to read.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n + 1 characters.
+ * \return The result of the operation.
+ */
+inline int Window::innstr(char* str, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return winnstr(win_, str, static_cast<int>(n));
+}
+
 /**
  * \brief Call mvwinnstr for this window.
  * 
@@ -251,6 +268,21 @@ inline int Window::mvinnstr(int y, int x, std::string& str, std::size_t n)
 	return (this->move)(y, x) == ERR ? ERR : (this->innstr)(str, n);
 }
 
+/**
+ * \brief Call mvwinnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param[out] str The resulting null-terminated string.
+ * \param n Number of characters to read.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n + 1 characters.
+ * \return The result of the operation.
+ */
+inline int Window::mvinnstr(int y, int x, char* str, std::size_t n)
+{
+	return (this->move)(y, x) == ERR ? ERR : (this->innstr)(str, n);
+}
+
 // inchstr
 
 /**
@@ -282,6 +314,23 @@ inline int Window::inchnstr(String& str, std::size_t n)
 	return winchnstr(win_, &str[0], static_cast<int>(n));
 }
 
+/**
+ * \brief Call winchnstr for this window.
+ * 
+ * No allocation is performed, the caller owns the buffer.
+ * 
+ * \param[out] str The resulting zero-terminated string.
+ * \param n Number of characters to read.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n + 1 characters.
+ * \return The result of the operation.
+ */
+inline int Window::inchnstr(chtype* str, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return winchnstr(win_, str, static_cast<int>(n));
+}
+
 /**
  * \brief Call mvwinchnstr for this window.
  * 
@@ -311,6 +360,123 @@ inline int Window::mvinchnstr(int y, int x, String& str, std::size_t n)
 	return (this->move)(y, x) == ERR ? ERR : (this->inchnstr)(str, n);
 }
 
+/**
+ * \brief Call mvwinchnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param[out] str The resulting zero-terminated string.
+ * \param n Number of characters to read.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n + 1 characters.
+ * \return The result of the operation.
+ */
+inline int Window::mvinchnstr(int y, int x, chtype* str, std::size_t n)
+{
+	return (this->move)(y, x) == ERR ? ERR : (this->inchnstr)(str, n);
+}
+
+// read_events
+
+/// \cond NODOC
+namespace internal
+{
+
+inline bool is_mouse_motion(MEVENT const& event)
+{
+	return (event.bstate & ~static_cast<mmask_t>(BUTTON_CTRL | BUTTON_SHIFT | BUTTON_ALT)) == REPORT_MOUSE_POSITION;
+}
+
+} // namespace internal
+/// \endcond
+
+/**
+ * \brief Read all the pending input of this window without blocking.
+ * 
+ * The keys are read with wgetch until no input is left or the buffer is full. Function keys,
+ * mouse events (read with getmouse) and resizes are decoded. Consecutive mouse motion events
+ * without button change are coalesced into the last one. No memory is allocated.
+ * The delay mode of the window is restored before returning.
+ * 
+ * \param[out] events The buffer receiving the events.
+ * \param capacity The number of events the buffer can hold.
+ * \pre The Window manages a ncurses window.
+ * \return The number of events written.
+ */
+inline std::size_t Window::read_events(Event* events, std::size_t capacity)
+{
+	assert(win_ && "Window doesn't manage any object");
+	int delay{wgetdelay(win_)};
+	wtimeout(win_, 0);
+	std::size_t n{0};
+	while (n != capacity)
+	{
+		int ch{wgetch(win_)};
+		if (ch == ERR)
+			break;
+		Event& event = events[n];
+		event.key = ch;
+		if (ch == KEY_MOUSE)
+		{
+			if (::getmouse(&event.mouse) != OK)
+				continue;
+			event.type = Event::Type::mouse;
+			if (n != 0 && internal::is_mouse_motion(event.mouse))
+			{
+				Event& last = events[n - 1];
+				if (last.type == Event::Type::mouse && last.mouse.bstate == event.mouse.bstate &&
+				    last.mouse.id == event.mouse.id)
+				{
+					last.mouse = event.mouse;
+					continue;
+				}
+			}
+		}
+		else if (ch == KEY_RESIZE)
+		{
+			event.type = Event::Type::resize;
+			event.lines = LINES;
+			event.cols = COLS;
+		}
+		else if (ch >= KEY_F0 && ch < KEY_F0 + 64)
+		{
+			event.type = Event::Type::function_key;
+			event.function = ch - KEY_F0;
+		}
+		else
+			event.type = Event::Type::key;
+		++n;
+	}
+	wtimeout(win_, delay);
+	return n;
+}
+
+/**
+ * \brief Read all the pending input of this window without blocking.
+ * 
+ * \param[out] events The buffer receiving the events.
+ * \pre The Window manages a ncurses window.
+ * \return The number of events written.
+ */
+template <std::size_t N>
+inline std::size_t Window::read_events(Event (&events)[N])
+{
+	return (this->read_events)(events, N);
+}
+
+#ifdef NCCPP_HAS_SPAN
+/**
+ * \brief Read all the pending input of this window without blocking.
+ * 
+ * \param[out] events The buffer receiving the events.
+ * \pre The Window manages a ncurses window.
+ * \return The number of events written.
+ */
+inline std::size_t Window::read_events(std::span<Event> events)
+{
+	return (this->read_events)(events.data(), events.size());
+}
+#endif
+
 } // namespace nccpp
 
 #endif // Header guard
@@ -65,6 +65,22 @@ inline int Window::mvwin(int y, int x)
 	return ::mvwin(win_, y, x);
 }
 
+/**
+ * \brief Call wresize for this window.
+ * 
+ * The content is kept where it overlaps the new size, and the new cells are blank. Subwindows are
+ * shrunk if they don't fit anymore, and keep sharing the cells of the window.
+ * 
+ * \param lines,cols New size.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::resize(int lines, int cols)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return wresize(win_, lines, cols);
+}
+
 /**
  * \brief Call werase for this window.
  * 
@@ -116,13 +132,28 @@ inline int Window::clrtoeol()
 /**
  * \brief Call wrefresh for this window.
  * 
+ * If the frame scheduler coalesces refreshes, the window is scheduled for the next frame instead.
+ * Pad overrides this function to call prefresh.
+ * 
  * \pre The Window manages a ncurses window.
  * \return The result of the operation.
  */
 inline int Window::refresh()
 {
 	assert(win_ && "Window doesn't manage any object");
-	return wrefresh(win_);
+	assert((!owning_screen_ || owning_screen_->owns_thread_()) && "Screen is used from the wrong thread");
+	auto& screen = (this->get_owning_screen)();
+	auto& scheduler = screen.get_frame_scheduler();
+	if (scheduler.is_coalescing())
+	{
+		scheduler.schedule(*this);
+		return OK;
+	}
+	NCCPP_RECORD(*this, refreshes, 1);
+	NCCPP_TIME_SCOPE(instrumentation_.refresh_time);
+	auto ret = wrefresh(win_);
+	screen.end_frame_(Key{});
+	return ret;
 }
 
 /**
@@ -134,6 +165,8 @@ inline int Window::refresh()
 inline int Window::outrefresh()
 {
 	assert(win_ && "Window doesn't manage any object");
+	assert((!owning_screen_ || owning_screen_->owns_thread_()) && "Screen is used from the wrong thread");
+	NCCPP_RECORD(*this, outrefreshes, 1);
 	return wnoutrefresh(win_);
 }
 
@@ -221,6 +254,7 @@ inline void Window::get_maxyx(int& y, int& x)
 inline int Window::touchln(int start, int count, bool changed)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD(*this, touched_lines, static_cast<std::size_t>(std::max(count, 0)));
 	return wtouchln(win_, start, count, changed);
 }
 
@@ -51,6 +51,7 @@ namespace nccpp
 inline int Window::addch(chtype const ch)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addch, 1);
 	return waddch(win_, ch);
 }
 
@@ -64,6 +65,7 @@ inline int Window::addch(chtype const ch)
 inline int Window::mvaddch(int y, int x, chtype const ch)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addch, 1);
 	return mvwaddch(win_, y, x, ch);
 }
 
@@ -77,47 +79,99 @@ inline int Window::mvaddch(int y, int x, chtype const ch)
 inline int Window::echochar(chtype const ch)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addch, 1);
 	return wechochar(win_, ch);
 }
 
 // printw
 
 /**
- * \brief Call wprintw for this window.
+ * \brief Call vw_printw for this window.
  * 
- * \param fmt Value to pass on to wprintw.
+ * This overload is only used when some arguments can't be formatted by the checked one, pointers for
+ * example. The format string isn't checked.
+ * 
+ * \param fmt Value to pass on to vw_printw.
  * \pre The Window manages a ncurses window.
  * \return The result of the operation.
  */
-inline int Window::printw(char const* fmt, ...)
+inline int Window::printw(internal::VarargsFormat fmt, ...)
 {
 	assert(win_ && "Window doesn't manage any object");
+	// The length of the output isn't known here
+	NCCPP_RECORD_OUTPUT(*this, printw, 0);
 	va_list args;
 	va_start(args, fmt);
-	auto ret = vw_printw(win_, fmt, args);
+	auto ret = vw_printw(win_, fmt.str, args);
 	va_end(args);
 	return ret;
 }
 
 /**
- * \brief Call mvwprintw for this window.
+ * \brief Move the cursor and call vw_printw for this window.
+ * 
+ * This overload is only used when some arguments can't be formatted by the checked one, pointers for
+ * example. The format string isn't checked.
  * 
- * \param y,x,fmt Values to pass on to wprintw.
+ * \param y,x,fmt Values to pass on to vw_printw.
  * \pre The Window manages a ncurses window.
  * \return The result of the operation.
  */
-inline int Window::mvprintw(int y, int x, char const* fmt, ...)
+inline int Window::mvprintw(int y, int x, internal::VarargsFormat fmt, ...)
 {
 	assert(win_ && "Window doesn't manage any object");
 	if ((this->move)(y, x) == ERR)
 		return ERR;
+	NCCPP_RECORD_OUTPUT(*this, printw, 0);
 	va_list args;
 	va_start(args, fmt);
-	auto ret = vw_printw(win_, fmt, args);
+	auto ret = vw_printw(win_, fmt.str, args);
 	va_end(args);
 	return ret;
 }
 
+/**
+ * \brief Format the arguments and call waddnstr for this window.
+ * 
+ * The arguments are formatted into a stack buffer of NCCPP_PRINTW_BUFFER_SIZE characters, without any
+ * allocation, and the result is printed with a single call to waddnstr.
+ * This overload is chosen whenever every argument is an integer, a floating-point number or a string.
+ * 
+ * \param fmt The format string. See FormatString for the supported conversions.
+ * \param args The values to format.
+ * \pre The Window manages a ncurses window.
+ * \pre *fmt* matches the types of *args*.
+ * \return The result of the operation.
+ */
+template <typename... Args>
+typename std::enable_if<internal::IsFormattable<Args...>::value, int>::type
+Window::printw(FormatString<typename internal::Identity<Args>::type...> fmt, Args const&... args)
+{
+	assert(win_ && "Window doesn't manage any object");
+	internal::FormatBuffer<NCCPP_PRINTW_BUFFER_SIZE> buf{};
+	internal::format_args(buf, fmt.get(), args...);
+	NCCPP_RECORD_OUTPUT(*this, printw, buf.size());
+	return waddnstr(win_, buf.data(), static_cast<int>(buf.size()));
+}
+
+/**
+ * \brief Move the cursor, format the arguments and call waddnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param fmt The format string. See FormatString for the supported conversions.
+ * \param args The values to format.
+ * \pre The Window manages a ncurses window.
+ * \pre *fmt* matches the types of *args*.
+ * \return The result of the operation.
+ */
+template <typename... Args>
+typename std::enable_if<internal::IsFormattable<Args...>::value, int>::type
+Window::mvprintw(int y, int x, FormatString<typename internal::Identity<Args>::type...> fmt, Args const&... args)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return (this->move)(y, x) == ERR ? ERR : (this->printw)(fmt, args...);
+}
+
 // addstr
 
 /**
@@ -131,7 +185,21 @@ inline int Window::mvprintw(int y, int x, char const* fmt, ...)
  */
 inline int Window::addstr(std::string const& str)
 {
-	return (this->addnstr)(str, str.size());
+	return (this->addnstr)(str.data(), str.size());
+}
+
+/**
+ * \brief Call waddstr for this window.
+ * 
+ * \param str The null-terminated string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::addstr(char const* str)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addstr, std::strlen(str));
+	return waddnstr(win_, str, -1);
 }
 
 /**
@@ -145,9 +213,26 @@ inline int Window::addstr(std::string const& str)
  */
 inline int Window::addnstr(std::string const& str, std::size_t n)
 {
-	assert(win_ && "Window doesn't manage any object");
 	assert(n <= str.size());
-	return waddnstr(win_, str.c_str(), static_cast<int>(n));
+	return (this->addnstr)(str.data(), n);
+}
+
+/**
+ * \brief Call waddnstr for this window.
+ * 
+ * The string doesn't need to be null-terminated.
+ * 
+ * \param str The string to print.
+ * \param n Number of characters to print.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n characters.
+ * \return The result of the operation.
+ */
+inline int Window::addnstr(char const* str, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addstr, n);
+	return waddnstr(win_, str, static_cast<int>(n));
 }
 
 /**
@@ -162,7 +247,20 @@ inline int Window::addnstr(std::string const& str, std::size_t n)
  */
 inline int Window::mvaddstr(int y, int x, std::string const& str)
 {
-	return (this->mvaddnstr)(y, x, str, str.size());
+	return (this->mvaddnstr)(y, x, str.data(), str.size());
+}
+
+/**
+ * \brief Call mvwaddstr for this window.
+ * 
+ * \param y,x New position.
+ * \param str The null-terminated string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::mvaddstr(int y, int x, char const* str)
+{
+	return (this->move)(y, x) == ERR ? ERR : (this->addstr)(str);
 }
 
 /**
@@ -176,16 +274,59 @@ inline int Window::mvaddstr(int y, int x, std::string const& str)
  * \return The result of the operation.
  */
 inline int Window::mvaddnstr(int y, int x, std::string const& str, std::size_t n)
+{
+	assert(n <= str.size());
+	return (this->mvaddnstr)(y, x, str.data(), n);
+}
+
+/**
+ * \brief Call mvwaddnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print.
+ * \param n Number of characters to print.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n characters.
+ * \return The result of the operation.
+ */
+inline int Window::mvaddnstr(int y, int x, char const* str, std::size_t n)
 {
 	return (this->move)(y, x) == ERR ? ERR : (this->addnstr)(str, n);
 }
 
+#ifdef NCCPP_HAS_STRING_VIEW
+/**
+ * \brief Call waddnstr for this window.
+ * 
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::addstr(std::string_view str)
+{
+	return (this->addnstr)(str.data(), str.size());
+}
+
+/**
+ * \brief Call mvwaddnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::mvaddstr(int y, int x, std::string_view str)
+{
+	return (this->mvaddnstr)(y, x, str.data(), str.size());
+}
+#endif
+
 // addchstr
 
 /**
  * \brief Call waddchnstr for this window.
  * 
- * The function prints str.size() characters.
+ * The function prints chstr.size() characters.
  * 
  * \param chstr The string to print.
  * \pre The Window manages a ncurses window.
@@ -193,7 +334,21 @@ inline int Window::mvaddnstr(int y, int x, std::string const& str, std::size_t n
  */
 inline int Window::addchstr(String const& chstr)
 {
-	return (this->addchnstr)(chstr, chstr.size());
+	return (this->addchnstr)(chstr.data(), chstr.size());
+}
+
+/**
+ * \brief Call waddchstr for this window.
+ * 
+ * \param chstr The null-terminated string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::addchstr(chtype const* chstr)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addchstr, internal::chstr_length(chstr));
+	return waddchnstr(win_, chstr, -1);
 }
 
 /**
@@ -202,20 +357,37 @@ inline int Window::addchstr(String const& chstr)
  * \param chstr The string to print.
  * \param n Number of characters to print.
  * \pre The Window manages a ncurses window.
- * \pre n <= str.size()
+ * \pre n <= chstr.size()
  * \return The result of the operation.
  */
 inline int Window::addchnstr(String const& chstr, std::size_t n)
 {
-	assert(win_ && "Window doesn't manage any object");
 	assert(n <= chstr.size());
-	return waddchnstr(win_, chstr.c_str(), static_cast<int>(n));
+	return (this->addchnstr)(chstr.data(), n);
+}
+
+/**
+ * \brief Call waddchnstr for this window.
+ * 
+ * The string doesn't need to be null-terminated.
+ * 
+ * \param chstr The string to print.
+ * \param n Number of characters to print.
+ * \pre The Window manages a ncurses window.
+ * \pre *chstr* points to at least n characters.
+ * \return The result of the operation.
+ */
+inline int Window::addchnstr(chtype const* chstr, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, addchstr, n);
+	return waddchnstr(win_, chstr, static_cast<int>(n));
 }
 
 /**
  * \brief Call mvwaddchnstr for this window.
  * 
- * The function prints str.size() characters.
+ * The function prints chstr.size() characters.
  * 
  * \param y,x New position.
  * \param chstr The string to print.
@@ -224,7 +396,20 @@ inline int Window::addchnstr(String const& chstr, std::size_t n)
  */
 inline int Window::mvaddchstr(int y, int x, String const& chstr)
 {
-	return (this->mvaddchnstr)(y, x, chstr.c_str(), chstr.size());
+	return (this->mvaddchnstr)(y, x, chstr.data(), chstr.size());
+}
+
+/**
+ * \brief Call mvwaddchstr for this window.
+ * 
+ * \param y,x New position.
+ * \param chstr The null-terminated string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::mvaddchstr(int y, int x, chtype const* chstr)
+{
+	return (this->move)(y, x) == ERR ? ERR : (this->addchstr)(chstr);
 }
 
 /**
@@ -234,14 +419,57 @@ inline int Window::mvaddchstr(int y, int x, String const& chstr)
  * \param chstr The string to print.
  * \param n Number of characters to print.
  * \pre The Window manages a ncurses window.
- * \pre n <= str.size()
+ * \pre n <= chstr.size()
  * \return The result of the operation.
  */
 inline int Window::mvaddchnstr(int y, int x, String const& chstr, std::size_t n)
 {
-	return (this->move)(y, x) ? ERR : (this->addchnstr)(chstr, n);
+	assert(n <= chstr.size());
+	return (this->mvaddchnstr)(y, x, chstr.data(), n);
+}
+
+/**
+ * \brief Call mvwaddchnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param chstr The string to print.
+ * \param n Number of characters to print.
+ * \pre The Window manages a ncurses window.
+ * \pre *chstr* points to at least n characters.
+ * \return The result of the operation.
+ */
+inline int Window::mvaddchnstr(int y, int x, chtype const* chstr, std::size_t n)
+{
+	return (this->move)(y, x) == ERR ? ERR : (this->addchnstr)(chstr, n);
 }
 
+#ifdef NCCPP_HAS_SPAN
+/**
+ * \brief Call waddchnstr for this window.
+ * 
+ * \param chstr The characters to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::addchstr(std::span<chtype const> chstr)
+{
+	return (this->addchnstr)(chstr.data(), chstr.size());
+}
+
+/**
+ * \brief Call mvwaddchnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param chstr The characters to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::mvaddchstr(int y, int x, std::span<chtype const> chstr)
+{
+	return (this->mvaddchnstr)(y, x, chstr.data(), chstr.size());
+}
+#endif
+
 // insch
 
 /**
@@ -254,6 +482,7 @@ inline int Window::mvaddchnstr(int y, int x, String const& chstr, std::size_t n)
 inline int Window::insch(chtype ch)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, insch, 1);
 	return winsch(win_, ch);
 }
 
@@ -267,6 +496,7 @@ inline int Window::insch(chtype ch)
 inline int Window::mvinsch(int y, int x, chtype ch)
 {
 	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, insch, 1);
 	return mvwinsch(win_, y, x, ch);
 }
 
@@ -283,7 +513,21 @@ inline int Window::mvinsch(int y, int x, chtype ch)
  */
 inline int Window::insstr(std::string const& str)
 {
-	return (this->insnstr)(str, str.size());
+	return (this->insnstr)(str.data(), str.size());
+}
+
+/**
+ * \brief Call winsstr for this window.
+ * 
+ * \param str The null-terminated string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::insstr(char const* str)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, insstr, std::strlen(str));
+	return winsnstr(win_, str, -1);
 }
 
 /**
@@ -297,9 +541,26 @@ inline int Window::insstr(std::string const& str)
  */
 inline int Window::insnstr(std::string const& str, std::size_t n)
 {
-	assert(win_ && "Window doesn't manage any object");
 	assert(n <= str.size());
-	return winsnstr(win_, str.c_str(), static_cast<int>(n));
+	return (this->insnstr)(str.data(), n);
+}
+
+/**
+ * \brief Call winsnstr for this window.
+ * 
+ * The string doesn't need to be null-terminated.
+ * 
+ * \param str The string to print.
+ * \param n Number of characters to print.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n characters.
+ * \return The result of the operation.
+ */
+inline int Window::insnstr(char const* str, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, insstr, n);
+	return winsnstr(win_, str, static_cast<int>(n));
 }
 
 /**
@@ -314,7 +575,20 @@ inline int Window::insnstr(std::string const& str, std::size_t n)
  */
 inline int Window::mvinsstr(int y, int x, std::string const& str)
 {
-	return (this->mvinsnstr)(y, x, str, str.size());
+	return (this->mvinsnstr)(y, x, str.data(), str.size());
+}
+
+/**
+ * \brief Call mvwinsstr for this window.
+ * 
+ * \param y,x New position.
+ * \param str The null-terminated string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::mvinsstr(int y, int x, char const* str)
+{
+	return (this->move)(y, x) == ERR ? ERR : (this->insstr)(str);
 }
 
 /**
@@ -328,10 +602,514 @@ inline int Window::mvinsstr(int y, int x, std::string const& str)
  * \return The result of the operation.
  */
 inline int Window::mvinsnstr(int y, int x, std::string const& str, std::size_t n)
+{
+	assert(n <= str.size());
+	return (this->mvinsnstr)(y, x, str.data(), n);
+}
+
+/**
+ * \brief Call mvwinsnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print.
+ * \param n Number of characters to print.
+ * \pre The Window manages a ncurses window.
+ * \pre *str* points to at least n characters.
+ * \return The result of the operation.
+ */
+inline int Window::mvinsnstr(int y, int x, char const* str, std::size_t n)
 {
 	return (this->move)(y, x) == ERR ? ERR : (this->insnstr)(str, n);
 }
 
+#ifdef NCCPP_HAS_STRING_VIEW
+/**
+ * \brief Call winsnstr for this window.
+ * 
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::insstr(std::string_view str)
+{
+	return (this->insnstr)(str.data(), str.size());
+}
+
+/**
+ * \brief Call mvwinsnstr for this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::mvinsstr(int y, int x, std::string_view str)
+{
+	return (this->mvinsnstr)(y, x, str.data(), str.size());
+}
+#endif
+
+// blit
+
+/**
+ * \brief Write a rectangle of characters into this window.
+ * 
+ * Row i of the rectangle is read from cells + i * stride. The rectangle is
+ * clipped against the window, so y and x may be negative and the rectangle
+ * may extend past the bottom right corner. Each visible row is written with a
+ * single waddchnstr call, so only the touched part of each line is marked as
+ * changed. As with addchnstr, a null character ends its row early.
+ * The cursor position is left unchanged.
+ * 
+ * This function is a convenience, not a faster path : ncurses doesn't expose
+ * its line data, so it costs about the same as calling mvaddchnstr for each
+ * clipped row.
+ * 
+ * \param y,x Position of the top left corner of the rectangle.
+ * \param rows,cols Size of the rectangle.
+ * \param cells The characters to write.
+ * \param stride Distance between the first characters of two consecutive rows.
+ * \pre The Window manages a ncurses window.
+ * \pre rows >= 0 and cols >= 0.
+ * \pre *cells* points to at least (rows - 1) * stride + cols characters.
+ * \return OK, even when the rectangle is entirely clipped, or ERR on failure.
+ */
+inline int Window::blit(int y, int x, int rows, int cols, chtype const* cells, std::size_t stride)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, blit, static_cast<std::size_t>(std::max(rows, 0)) *
+	                                 static_cast<std::size_t>(std::max(cols, 0)));
+	if (!(this->clip_rect_)(y, x, rows, cols, cells, stride))
+		return OK;
+
+	int cur_y{getcury(win_)}, cur_x{getcurx(win_)};
+	int ret{OK};
+	for (int i{0}; i != rows; ++i, cells += stride)
+		if (wmove(win_, y + i, x) == ERR || waddchnstr(win_, cells, cols) == ERR)
+			ret = ERR;
+	wmove(win_, cur_y, cur_x);
+	return ret;
+}
+
+/**
+ * \brief Write a rectangle of characters into this window, skipping transparent cells.
+ * 
+ * Behaves like the other blit overload, except that the cells equal to
+ * *transparent* are left untouched in the window. Each run of opaque cells is
+ * written with a single waddchnstr call.
+ * 
+ * \param y,x Position of the top left corner of the rectangle.
+ * \param rows,cols Size of the rectangle.
+ * \param cells The characters to write.
+ * \param stride Distance between the first characters of two consecutive rows.
+ * \param transparent Value of the cells which must not be written.
+ * \pre The Window manages a ncurses window.
+ * \pre rows >= 0 and cols >= 0.
+ * \pre *cells* points to at least (rows - 1) * stride + cols characters.
+ * \return OK, even when the rectangle is entirely clipped, or ERR on failure.
+ */
+inline int Window::blit(int y, int x, int rows, int cols, chtype const* cells, std::size_t stride,
+                        chtype transparent)
+{
+	assert(win_ && "Window doesn't manage any object");
+	NCCPP_RECORD_OUTPUT(*this, blit, static_cast<std::size_t>(std::max(rows, 0)) *
+	                                 static_cast<std::size_t>(std::max(cols, 0)));
+	if (!(this->clip_rect_)(y, x, rows, cols, cells, stride))
+		return OK;
+
+	int cur_y{getcury(win_)}, cur_x{getcurx(win_)};
+	int ret{OK};
+	for (int i{0}; i != rows; ++i, cells += stride)
+	{
+		int first{0};
+		while (first != cols)
+		{
+			while (first != cols && cells[first] == transparent)
+				++first;
+			int last{first};
+			while (last != cols && cells[last] != transparent)
+				++last;
+			if (last != first && (wmove(win_, y + i, x + first) == ERR ||
+			                      waddchnstr(win_, cells + first, last - first) == ERR))
+				ret = ERR;
+			first = last;
+		}
+	}
+	wmove(win_, cur_y, cur_x);
+	return ret;
+}
+
+/// \cond NODOC
+inline bool Window::clip_rect_(int& y, int& x, int& rows, int& cols, chtype const*& cells, std::size_t stride)
+{
+	assert(rows >= 0 && cols >= 0 && "Negative rectangle size");
+	int max_y{getmaxy(win_)}, max_x{getmaxx(win_)};
+	if (y < 0)
+	{
+		rows += y;
+		cells += static_cast<std::size_t>(-y) * stride;
+		y = 0;
+	}
+	if (x < 0)
+	{
+		cols += x;
+		cells += -x;
+		x = 0;
+	}
+	if (y >= max_y || x >= max_x || rows <= 0 || cols <= 0)
+		return false;
+	rows = std::min(rows, max_y - y);
+	cols = std::min(cols, max_x - x);
+	return true;
+}
+/// \endcond
+
+// add_utf8
+
+/**
+ * \brief Write UTF-8 text into this window.
+ * 
+ * The text is written like with addchnstr, using the window's current attributes
+ * and color pair : it is truncated at the right margin, isn't wrapped, and the
+ * cursor position is left unchanged. Runs of ASCII characters are detected
+ * several bytes at a time and written through waddchnstr without being
+ * decoded, the remaining code points are stored in cchar_t cells, with
+ * combining characters attached to the preceding cell, and written with
+ * wadd_wchnstr. Malformed sequences and non-printable code points are
+ * displayed as U+FFFD.
+ * 
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ */
+inline int Window::add_utf8(std::string const& str)
+{
+	return (this->add_utf8)(str.data(), str.size());
+}
+
+/**
+ * \brief Write null-terminated UTF-8 text into this window.
+ * 
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ * \sa add_utf8(std::string const&)
+ */
+inline int Window::add_utf8(char const* str)
+{
+	return (this->add_utf8)(str, std::strlen(str));
+}
+
+/**
+ * \brief Write UTF-8 text into this window.
+ * 
+ * \param str The string to print. It doesn't need to be null-terminated.
+ * \param n Number of bytes to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ * \sa add_utf8(std::string const&)
+ */
+inline int Window::add_utf8(char const* str, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	attr_t attrs;
+	short pair;
+	if (wattr_get(win_, &attrs, &pair, nullptr) == ERR)
+		return ERR;
+	attrs &= ~A_COLOR;
+	// chtype can only hold the first 256 color pairs
+	bool narrow{pair < 256};
+	auto ch_attrs = static_cast<chtype>(attrs) | (narrow ? static_cast<chtype>(COLOR_PAIR(pair)) : 0);
+
+	int y{getcury(win_)}, x{getcurx(win_)}, max_x{getmaxx(win_)};
+	int col{x};
+	char const* end{str + n};
+	int ret{OK};
+	while (str != end && col < max_x && ret != ERR)
+	{
+		auto left = static_cast<std::size_t>(end - str);
+		auto ascii = narrow ? internal::ascii_prefix(str, left) : 0;
+		// The last ASCII character is left to the wide run, the next code point may combine with it
+		if (ascii != 0 && ascii != left)
+			--ascii;
+		if (ascii != 0)
+		{
+			ret = (this->add_ascii_run_)(y, col, max_x, str, ascii, ch_attrs);
+			str += ascii;
+		}
+		else
+			ret = (this->add_wide_run_)(y, col, max_x, str, end, attrs, pair, narrow);
+	}
+	NCCPP_RECORD_OUTPUT(*this, add_utf8, static_cast<std::size_t>(col - x));
+	wmove(win_, y, x);
+	return ret;
+}
+
+/**
+ * \brief Move the cursor and write UTF-8 text into this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ * \sa add_utf8(std::string const&)
+ */
+inline int Window::mvadd_utf8(int y, int x, std::string const& str)
+{
+	return (this->mvadd_utf8)(y, x, str.data(), str.size());
+}
+
+/**
+ * \brief Move the cursor and write null-terminated UTF-8 text into this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ * \sa add_utf8(std::string const&)
+ */
+inline int Window::mvadd_utf8(int y, int x, char const* str)
+{
+	return (this->mvadd_utf8)(y, x, str, std::strlen(str));
+}
+
+/**
+ * \brief Move the cursor and write UTF-8 text into this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print. It doesn't need to be null-terminated.
+ * \param n Number of bytes to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ * \sa add_utf8(std::string const&)
+ */
+inline int Window::mvadd_utf8(int y, int x, char const* str, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return (this->move)(y, x) == ERR ? ERR : (this->add_utf8)(str, n);
+}
+
+#ifdef NCCPP_HAS_STRING_VIEW
+/**
+ * \brief Write UTF-8 text into this window.
+ * 
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ * \sa add_utf8(std::string const&)
+ */
+inline int Window::add_utf8(std::string_view str)
+{
+	return (this->add_utf8)(str.data(), str.size());
+}
+
+/**
+ * \brief Move the cursor and write UTF-8 text into this window.
+ * 
+ * \param y,x New position.
+ * \param str The string to print.
+ * \pre The Window manages a ncurses window.
+ * \pre The locale uses UTF-8, and was set before ncurses was initialized.
+ * \pre The string doesn't contain any control character.
+ * \return The result of the operation.
+ * \sa add_utf8(std::string const&)
+ */
+inline int Window::mvadd_utf8(int y, int x, std::string_view str)
+{
+	return (this->mvadd_utf8)(y, x, str.data(), str.size());
+}
+#endif
+
+// add_runs
+
+/**
+ * \brief Write a sequence of styled runs into this window.
+ * 
+ * The attributes of the window are only changed, with wattr_set, between two runs of different
+ * styles, and are restored before returning. The pairs of the styles are used as is, without
+ * looking up any color. The text is written with waddnstr.
+ * 
+ * \param runs The runs to print.
+ * \param n Number of runs.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ */
+inline int Window::add_runs(StyledRun const* runs, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	attr_t attrs;
+	short pair;
+	if (wattr_get(win_, &attrs, &pair, nullptr) == ERR)
+		return ERR;
+	Style const saved{attrs, pair};
+	Style current{saved};
+	std::size_t cells{0};
+	int ret{OK};
+	for (auto run = runs, end = runs + n; run != end && ret != ERR; ++run)
+	{
+		if (run->length == 0)
+			continue;
+		if (run->style != current)
+		{
+			current = run->style;
+			wattr_set(win_, current.attributes(), current.pair_number(), nullptr);
+		}
+		ret = waddnstr(win_, run->text, static_cast<int>(run->length));
+		cells += run->length;
+	}
+	if (current != saved)
+		wattr_set(win_, saved.attributes(), saved.pair_number(), nullptr);
+	NCCPP_RECORD_OUTPUT(*this, add_runs, cells);
+	return ret;
+}
+
+/**
+ * \brief Write an array of styled runs into this window.
+ * 
+ * \param runs The runs to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ * \sa add_runs(StyledRun const*, std::size_t)
+ */
+template <std::size_t N>
+inline int Window::add_runs(StyledRun const (&runs)[N])
+{
+	return (this->add_runs)(runs, N);
+}
+
+/**
+ * \brief Move the cursor and write a sequence of styled runs into this window.
+ * 
+ * \param y,x New position.
+ * \param runs The runs to print.
+ * \param n Number of runs.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ * \sa add_runs(StyledRun const*, std::size_t)
+ */
+inline int Window::mvadd_runs(int y, int x, StyledRun const* runs, std::size_t n)
+{
+	assert(win_ && "Window doesn't manage any object");
+	return (this->move)(y, x) == ERR ? ERR : (this->add_runs)(runs, n);
+}
+
+#ifdef NCCPP_HAS_SPAN
+/**
+ * \brief Write a span of styled runs into this window.
+ * 
+ * \param runs The runs to print.
+ * \pre The Window manages a ncurses window.
+ * \return The result of the operation.
+ * \sa add_runs(StyledRun const*, std::size_t)
+ */
+inline int Window::add_runs(std::span<StyledRun const> runs)
+{
+	return (this->add_runs)(runs.data(), runs.size());
+}
+#endif
+
+/// \cond NODOC
+inline int Window::add_ascii_run_(int y, int& x, int max_x, char const* str, std::size_t n, chtype attrs)
+{
+	chtype cells[128];
+	auto count = std::min(n, static_cast<std::size_t>(max_x - x));
+	while (count != 0)
+	{
+		auto chunk = std::min(count, sizeof(cells) / sizeof(*cells));
+		for (std::size_t i{0}; i != chunk; ++i)
+			cells[i] = static_cast<unsigned char>(str[i]) | attrs;
+		if (wmove(win_, y, x) == ERR || waddchnstr(win_, cells, static_cast<int>(chunk)) == ERR)
+			return ERR;
+		x += static_cast<int>(chunk);
+		str += chunk;
+		count -= chunk;
+	}
+	return OK;
+}
+
+inline int Window::add_wide_run_(int y, int& x, int max_x, char const*& str, char const* end, attr_t attrs,
+                                 short pair, bool stop_at_ascii)
+{
+	std::size_t constexpr max_cells{64};
+	wchar_t chars[max_cells][CCHARW_MAX + 1];
+	std::size_t lengths[max_cells];
+	std::size_t count{0};
+	int width{0};
+
+	auto flush = [&]
+	{
+		cchar_t cells[max_cells];
+		for (std::size_t i{0}; i != count; ++i)
+		{
+			chars[i][lengths[i]] = L'\0';
+			setcchar(&cells[i], chars[i], attrs, pair, nullptr);
+		}
+		if (count != 0 && (wmove(win_, y, x) == ERR || wadd_wchnstr(win_, cells, static_cast<int>(count)) == ERR))
+			return ERR;
+		x += width;
+		count = 0;
+		width = 0;
+		return OK;
+	};
+
+	while (str != end)
+	{
+		// Stop at ASCII text, unless it may be followed by a combining character
+		if (count != 0 && stop_at_ascii && static_cast<unsigned char>(*str) < 0x80 &&
+		    internal::ascii_prefix(str, std::min<std::size_t>(end - str, 2)) == 2)
+			break;
+		char const* next{str};
+		auto cp = internal::decode_utf8(next, end);
+		int w{internal::code_point_width(cp)};
+		if (w < 0)
+		{
+			cp = internal::utf8_replacement;
+			w = 1;
+		}
+		if (w == 0 && count != 0)
+		{
+			if (lengths[count - 1] != CCHARW_MAX)
+				chars[count - 1][lengths[count - 1]++] = static_cast<wchar_t>(cp);
+			str = next;
+			continue;
+		}
+		if ((count == max_cells || x + width + std::max(w, 1) > max_x) && flush() == ERR)
+			return ERR;
+		if (x + std::max(w, 1) > max_x)
+		{
+			x = max_x;
+			break;
+		}
+		// A combining character without a base character is attached to a space
+		lengths[count] = 0;
+		if (w == 0)
+		{
+			chars[count][lengths[count]++] = L' ';
+			w = 1;
+		}
+		chars[count][lengths[count]++] = static_cast<wchar_t>(cp);
+		++count;
+		width += w;
+		str = next;
+	}
+	return flush();
+}
+/// \endcond
+
 // delch
 
 /**
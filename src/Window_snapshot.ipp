@@ -0,0 +1,517 @@
+/*****
+ * Copyright Benoit Vey (2015)
+ *
+ * benoit.vey@etu.upmc.fr
+ *
+ * This software is a library whose purpose is to provide a RAII-conform
+ * interface over the ncurses library.
+ *
+ * This software is governed by the CeCILL-B license under French law and
+ * abiding by the rules of distribution of free software.  You can  use, 
+ * modify and/ or redistribute the software under the terms of the CeCILL-B
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info". 
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability. 
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or 
+ * data to be ensured and,  more generally, to use and operate it in the 
+ * same conditions as regards security. 
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL-B license and that you accept its terms.
+ *****/
+
+#ifndef NCURSESCPP_WINDOW_SNAPSHOT_IPP_
+#define NCURSESCPP_WINDOW_SNAPSHOT_IPP_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nccpp
+{
+
+/// \cond NODOC
+namespace internal
+{
+
+// Header of the files written by Window::save. The cells follow it, row by row
+// for a full snapshot, or as runs each preceded by a SnapshotRun for a delta.
+struct SnapshotHeader
+{
+	char magic[4];
+	std::uint16_t version;
+	std::uint16_t kind;
+	std::uint32_t byte_order;
+	std::uint32_t cell_size;
+	std::int32_t lines;
+	std::int32_t cols;
+	std::int32_t cur_y;
+	std::int32_t cur_x;
+	std::uint64_t hash;
+	std::uint64_t base_hash;
+	std::uint32_t run_count;
+	std::uint32_t reserved;
+};
+
+struct SnapshotRun
+{
+	std::int32_t y;
+	std::int32_t x;
+	std::int32_t length;
+	std::int32_t reserved;
+};
+
+static_assert(sizeof(SnapshotHeader) % alignof(cchar_t) == 0 && sizeof(SnapshotRun) % alignof(cchar_t) == 0 &&
+              sizeof(cchar_t) % alignof(cchar_t) == 0, "The cells of a mapped snapshot must be aligned");
+
+constexpr char snapshot_magic[4] = {'N', 'C', 'S', 'S'};
+// Version 1 stored chtype cells, which lost the characters outside of the 8-bit range
+constexpr std::uint16_t snapshot_version{2};
+constexpr std::uint16_t snapshot_full{0};
+constexpr std::uint16_t snapshot_delta{1};
+constexpr std::uint32_t snapshot_byte_order{0x01020304};
+
+// FNV-1a over the cells taken 8 bytes at a time, used to check that a delta is applied on its base
+inline std::uint64_t hash_cells(cchar_t const* cells, std::size_t count)
+{
+	auto bytes = reinterpret_cast<char const*>(cells);
+	auto size = count * sizeof(cchar_t);
+	std::uint64_t hash{14695981039346656037ull};
+	std::size_t i{0};
+	for (std::uint64_t word; i + sizeof(word) <= size; i += sizeof(word))
+	{
+		std::memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * 1099511628211ull;
+	}
+	for (; i != size; ++i)
+		hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ull;
+	return hash;
+}
+
+inline bool same_cell(cchar_t const& lhs, cchar_t const& rhs)
+{
+	return std::memcmp(&lhs, &rhs, sizeof(cchar_t)) == 0;
+}
+
+// Convert a cell to the chtype waddchnstr turns back into the same cell, if there is one
+inline bool narrow_cell(cchar_t const& cell, chtype& ch)
+{
+	if (cell.chars[0] == 0 || cell.chars[0] > 0x7f || cell.chars[1] != 0 || (cell.attr & A_CHARTEXT) != 0)
+		return false;
+#if NCURSES_EXT_COLORS
+	if (cell.ext_color != PAIR_NUMBER(cell.attr))
+		return false;
+#endif
+	ch = static_cast<chtype>(cell.chars[0]) | (cell.attr & A_ATTRIBUTES);
+	return true;
+}
+
+// Ncurses marks the first column of a wide character with 1 in the character bits of its attributes,
+// and the following columns with 2, 3...
+inline bool is_wide_continuation(cchar_t const& cell)
+{
+	return (cell.attr & A_CHARTEXT) > 1;
+}
+
+// Read-only mapping of a snapshot file, with its header checked
+class MappedSnapshot
+{
+	public:
+	explicit MappedSnapshot(char const* path)
+		: data_{nullptr}, size_{0}
+	{
+		int fd{open(path, O_RDONLY | O_CLOEXEC)};
+		if (fd == -1)
+			return;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(SnapshotHeader))
+		{
+			auto size = static_cast<std::size_t>(st.st_size);
+			void* data{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+			if (data != MAP_FAILED)
+			{
+				data_ = static_cast<char const*>(data);
+				size_ = size;
+			}
+		}
+		close(fd);
+		if (data_ && !(this->valid_)())
+		{
+			munmap(const_cast<char*>(data_), size_);
+			data_ = nullptr;
+		}
+	}
+
+	MappedSnapshot(MappedSnapshot const&) = delete;
+	MappedSnapshot& operator=(MappedSnapshot const&) = delete;
+
+	~MappedSnapshot()
+	{
+		if (data_)
+			munmap(const_cast<char*>(data_), size_);
+	}
+
+	explicit operator bool() const
+	{
+		return data_ != nullptr;
+	}
+
+	SnapshotHeader const& header() const
+	{
+		return *reinterpret_cast<SnapshotHeader const*>(data_);
+	}
+
+	char const* body() const
+	{
+		return data_ + sizeof(SnapshotHeader);
+	}
+
+	std::size_t body_size() const
+	{
+		return size_ - sizeof(SnapshotHeader);
+	}
+
+	private:
+	bool valid_() const
+	{
+		auto& h = header();
+		if (std::memcmp(h.magic, snapshot_magic, sizeof(snapshot_magic)) != 0 || h.version != snapshot_version ||
+		    h.byte_order != snapshot_byte_order || h.cell_size != sizeof(cchar_t) || h.lines <= 0 || h.cols <= 0)
+			return false;
+		if (h.kind == snapshot_full)
+			return body_size() / sizeof(cchar_t) / static_cast<std::size_t>(h.cols) >=
+			       static_cast<std::size_t>(h.lines);
+		return h.kind == snapshot_delta;
+	}
+
+	char const* data_;
+	std::size_t size_;
+};
+
+inline bool write_all(int fd, void const* data, std::size_t size)
+{
+	auto p = static_cast<char const*>(data);
+	while (size != 0)
+	{
+		auto written = write(fd, p, size);
+		if (written == -1 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return false;
+		p += written;
+		size -= static_cast<std::size_t>(written);
+	}
+	return true;
+}
+
+// Write the snapshot next to *path*, sync it and rename it, so that a crash never leaves a
+// truncated file. The directory is synced too, so that the rename itself survives a crash.
+inline int write_snapshot(char const* path, SnapshotHeader const& header, void const* body, std::size_t size)
+{
+	std::string tmp{path};
+	tmp += ".tmp";
+	int fd{open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+	if (fd == -1)
+		return ERR;
+	bool ok{write_all(fd, &header, sizeof(header)) && write_all(fd, body, size) && fsync(fd) == 0};
+	ok = close(fd) == 0 && ok;
+	if (!ok || std::rename(tmp.c_str(), path) != 0)
+	{
+		unlink(tmp.c_str());
+		return ERR;
+	}
+
+	auto slash = std::strrchr(path, '/');
+	std::string dir{slash ? std::string(path, slash == path ? 1 : static_cast<std::size_t>(slash - path)) : "."};
+	int dir_fd{open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+	if (dir_fd == -1)
+		return ERR;
+	// Some file systems can't sync a directory, there is nothing more to do on them
+	ok = fsync(dir_fd) == 0 || errno == EINVAL;
+	close(dir_fd);
+	return ok ? OK : ERR;
+}
+
+} // namespace internal
+/// \endcond
+
+/**
+ * \brief Write the content of this window to a snapshot file.
+ * 
+ * The file holds every cell of the window as a cchar_t, row by row, after a
+ * small versioned header, so that Window::load can map it and write it back
+ * without decoding. Wide characters, combining characters and extended
+ * colors are preserved. The cursor position is saved too.
+ * The file is written under a temporary name, synced to the disk and then
+ * renamed, so an existing snapshot is never left truncated, even by a crash.
+ * Because of the syncs, saving costs at least one disk flush.
+ * 
+ * \param path Path of the file.
+ * \pre The Window manages a ncurses window.
+ * \return OK, or ERR if the file couldn't be written or synced.
+ */
+inline int Window::save(char const* path)
+{
+	assert(win_ && "Window doesn't manage any object");
+	internal::SnapshotHeader header{};
+	std::vector<cchar_t> cells;
+	(this->read_snapshot_)(header, cells);
+	header.kind = internal::snapshot_full;
+	return internal::write_snapshot(path, header, cells.data(), cells.size() * sizeof(cchar_t));
+}
+
+/**
+ * \brief Write the content of this window to a snapshot file.
+ * 
+ * \param path Path of the file.
+ * \pre The Window manages a ncurses window.
+ * \return OK, or ERR if the file couldn't be written or synced.
+ */
+inline int Window::save(std::string const& path)
+{
+	return (this->save)(path.c_str());
+}
+
+/**
+ * \brief Write the changes of this window since a full snapshot to a delta snapshot file.
+ * 
+ * Only the runs of cells which differ from *base* are written, nearby runs
+ * being merged when that is smaller than writing them apart. Loading the
+ * delta requires the window to hold the content of *base* : it is checked
+ * through a hash of the cells.
+ * 
+ * \param path Path of the file.
+ * \param base Path of a full snapshot of this window, written by the other overloads.
+ * \pre The Window manages a ncurses window.
+ * \return OK, or ERR if *base* isn't a full snapshot of a window of the same size,
+ * or if the file couldn't be written.
+ */
+inline int Window::save(char const* path, char const* base)
+{
+	assert(win_ && "Window doesn't manage any object");
+	internal::MappedSnapshot snapshot{base};
+	if (!snapshot || snapshot.header().kind != internal::snapshot_full)
+		return ERR;
+	internal::SnapshotHeader header{};
+	std::vector<cchar_t> cells;
+	(this->read_snapshot_)(header, cells);
+	if (header.lines != snapshot.header().lines || header.cols != snapshot.header().cols)
+		return ERR;
+	header.kind = internal::snapshot_delta;
+	header.base_hash = snapshot.header().hash;
+
+	// A gap shorter than a run header is cheaper to write than to skip
+	constexpr int max_gap{static_cast<int>((sizeof(internal::SnapshotRun) + sizeof(cchar_t) - 1) / sizeof(cchar_t))};
+	auto old_cells = reinterpret_cast<cchar_t const*>(snapshot.body());
+	std::vector<char> body;
+	for (int y{0}; y != header.lines; ++y)
+	{
+		auto offset = static_cast<std::size_t>(y) * static_cast<std::size_t>(header.cols);
+		auto row = cells.data() + offset;
+		auto old_row = old_cells + offset;
+		int x{0};
+		while (x != header.cols)
+		{
+			while (x != header.cols && internal::same_cell(row[x], old_row[x]))
+				++x;
+			if (x == header.cols)
+				break;
+			int first{x};
+			int last{x + 1};
+			for (x = last; x != header.cols && x - last < max_gap; ++x)
+				if (!internal::same_cell(row[x], old_row[x]))
+					last = x + 1;
+			// A run holds whole wide characters, wadd_wchnstr can't write half of one
+			while (first != 0 && internal::is_wide_continuation(row[first]))
+				--first;
+			while (last != header.cols && internal::is_wide_continuation(row[last]))
+				++last;
+			x = last;
+
+			internal::SnapshotRun run{y, first, last - first, 0};
+			auto run_bytes = reinterpret_cast<char const*>(&run);
+			auto cell_bytes = reinterpret_cast<char const*>(row);
+			body.insert(body.end(), run_bytes, run_bytes + sizeof(run));
+			body.insert(body.end(), cell_bytes + static_cast<std::size_t>(first) * sizeof(cchar_t),
+			            cell_bytes + static_cast<std::size_t>(last) * sizeof(cchar_t));
+			++header.run_count;
+		}
+	}
+	return internal::write_snapshot(path, header, body.data(), body.size());
+}
+
+/**
+ * \brief Write the changes of this window since a full snapshot to a delta snapshot file.
+ * 
+ * \param path Path of the file.
+ * \param base Path of a full snapshot of this window.
+ * \pre The Window manages a ncurses window.
+ * \return OK, or ERR if *base* isn't a full snapshot of a window of the same size,
+ * or if the file couldn't be written.
+ */
+inline int Window::save(std::string const& path, std::string const& base)
+{
+	return (this->save)(path.c_str(), base.c_str());
+}
+
+/**
+ * \brief Restore the content of this window from a snapshot file.
+ * 
+ * The file is mapped in memory and its cells are written straight from the
+ * mapping, one wadd_wchnstr call per row or run. A full snapshot of a window of another size is clipped to this
+ * window. A delta snapshot is only applied if this window holds the content
+ * of its base snapshot. The saved cursor position is restored if it is
+ * inside the window. The window isn't refreshed.
+ * 
+ * \param path Path of the file.
+ * \pre The Window manages a ncurses window.
+ * \return OK, or ERR if the file isn't a valid snapshot, or if it is a delta
+ * which doesn't apply to the current content of this window.
+ */
+inline int Window::load(char const* path)
+{
+	assert(win_ && "Window doesn't manage any object");
+	internal::MappedSnapshot snapshot{path};
+	if (!snapshot)
+		return ERR;
+	auto& header = snapshot.header();
+	auto cols = static_cast<std::size_t>(header.cols);
+	auto body = snapshot.body();
+
+	int ret{OK};
+	if (header.kind == internal::snapshot_full)
+		ret = (this->write_snapshot_cells_)(0, 0, std::min(header.lines, getmaxy(win_)),
+		                                    std::min(header.cols, getmaxx(win_)),
+		                                    reinterpret_cast<cchar_t const*>(body), cols);
+	else
+	{
+		internal::SnapshotHeader current{};
+		std::vector<cchar_t> current_cells;
+		(this->read_snapshot_)(current, current_cells);
+		if (current.lines != header.lines || current.cols != header.cols || current.hash != header.base_hash)
+			return ERR;
+
+		// Check every run before writing any of them, a delta is applied entirely or not at all
+		constexpr std::size_t run_size{sizeof(internal::SnapshotRun)};
+		auto end = body + snapshot.body_size();
+		auto p = body;
+		for (std::uint32_t i{0}; i != header.run_count; ++i)
+		{
+			if (static_cast<std::size_t>(end - p) < run_size)
+				return ERR;
+			auto& run = *reinterpret_cast<internal::SnapshotRun const*>(p);
+			if (run.y < 0 || run.y >= header.lines || run.x < 0 || run.length <= 0 ||
+			    run.length > header.cols - run.x || (static_cast<std::size_t>(end - p) - run_size) / sizeof(cchar_t) <
+			                                        static_cast<std::size_t>(run.length))
+				return ERR;
+			p += run_size + static_cast<std::size_t>(run.length) * sizeof(cchar_t);
+		}
+		p = body;
+		for (std::uint32_t i{0}; i != header.run_count; ++i)
+		{
+			auto& run = *reinterpret_cast<internal::SnapshotRun const*>(p);
+			if ((this->write_snapshot_cells_)(run.y, run.x, 1, run.length,
+			                                  reinterpret_cast<cchar_t const*>(p + run_size),
+			                                  static_cast<std::size_t>(run.length)) == ERR)
+				ret = ERR;
+			p += run_size + static_cast<std::size_t>(run.length) * sizeof(cchar_t);
+		}
+	}
+	if (header.cur_y >= 0 && header.cur_x >= 0 && header.cur_y < getmaxy(win_) && header.cur_x < getmaxx(win_))
+		wmove(win_, header.cur_y, header.cur_x);
+	return ret;
+}
+
+/**
+ * \brief Restore the content of this window from a snapshot file.
+ * 
+ * \param path Path of the file.
+ * \pre The Window manages a ncurses window.
+ * \return OK, or ERR if the file isn't a valid snapshot, or if it is a delta
+ * which doesn't apply to the current content of this window.
+ */
+inline int Window::load(std::string const& path)
+{
+	return (this->load)(path.c_str());
+}
+
+/// \cond NODOC
+inline void Window::read_snapshot_(internal::SnapshotHeader& header, std::vector<cchar_t>& cells)
+{
+	int rows{getmaxy(win_)}, cols{getmaxx(win_)};
+	std::memcpy(header.magic, internal::snapshot_magic, sizeof(header.magic));
+	header.version = internal::snapshot_version;
+	header.byte_order = internal::snapshot_byte_order;
+	header.cell_size = sizeof(cchar_t);
+	header.lines = rows;
+	header.cols = cols;
+	header.cur_y = getcury(win_);
+	header.cur_x = getcurx(win_);
+
+	// win_wchnstr skips the continuation columns of wide characters, they are read one by one
+	// to keep every cell at the index of its column
+	auto count = static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols);
+	cells.resize(count);
+	std::vector<cchar_t> line(static_cast<std::size_t>(cols) + 1);
+	for (int y{0}; y != rows; ++y)
+	{
+		auto row = cells.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(cols);
+		mvwin_wchnstr(win_, y, 0, line.data(), cols);
+		for (int x{0}, i{0}; x != cols && i != cols; ++i)
+		{
+			row[x++] = line[static_cast<std::size_t>(i)];
+			if ((line[static_cast<std::size_t>(i)].attr & A_CHARTEXT) != 1)
+				continue;
+			while (x != cols && mvwin_wch(win_, y, x, row + x) == OK && internal::is_wide_continuation(row[x]))
+				++x;
+		}
+	}
+	wmove(win_, header.cur_y, header.cur_x);
+	header.hash = internal::hash_cells(cells.data(), count);
+}
+
+inline int Window::write_snapshot_cells_(int y, int x, int rows, int cols, cchar_t const* cells,
+                                         std::size_t stride)
+{
+	NCCPP_RECORD_OUTPUT(*this, blit, static_cast<std::size_t>(std::max(rows, 0)) *
+	                                 static_cast<std::size_t>(std::max(cols, 0)));
+	int cur_y{getcury(win_)}, cur_x{getcurx(win_)};
+	int ret{OK};
+	// wadd_wchnstr measures every character, rows of ASCII cells are much faster to write as chtypes
+	std::vector<chtype> narrow(static_cast<std::size_t>(std::max(cols, 0)));
+	for (int i{0}; i < rows; ++i, cells += stride)
+	{
+		int n{0};
+		while (n != cols && internal::narrow_cell(cells[n], narrow[static_cast<std::size_t>(n)]))
+			++n;
+		if (wmove(win_, y + i, x) == ERR ||
+		    (n == cols ? waddchnstr(win_, narrow.data(), cols) : wadd_wchnstr(win_, cells, cols)) == ERR)
+			ret = ERR;
+	}
+	wmove(win_, cur_y, cur_x);
+	return ret;
+}
+/// \endcond
+
+} // namespace nccpp
+
+#endif // Header guard
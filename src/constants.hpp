@@ -79,7 +79,7 @@ struct DefaultColor
 		static bool init_done{false};
 		if (!init_done)
 		{
-			ncurses().use_default_colors();
+			current_screen().use_default_colors();
 			init_done = true;
 		}
 		return -1;
@@ -220,7 +220,9 @@ int constexpr suspend{KEY_SUSPEND};
 int constexpr undo{KEY_UNDO};
 int constexpr mouse{KEY_MOUSE};
 int constexpr resize{KEY_RESIZE};
+#ifdef KEY_EVENT
 int constexpr event{KEY_EVENT};
+#endif
 
 } // namespace keys
 
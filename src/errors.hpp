@@ -92,6 +92,82 @@ class NcursesInit : public Base
 	}
 };
 
+/**
+ * \brief Thrown when a screen can't be created.
+ */
+class ScreenInit : public Base
+{
+	public:
+	ScreenInit() noexcept = default;
+
+	ScreenInit(ScreenInit const&) noexcept = default;
+	ScreenInit& operator=(ScreenInit const&) noexcept = default;
+
+	virtual ~ScreenInit() = default;
+
+	char const* what() const noexcept override
+	{
+		return "nccpp::errors::ScreenInit : Can't create screen, newterm() failed";
+	}
+};
+
+/**
+ * \brief Thrown when a virtual terminal can't be created.
+ */
+class TerminalInit : public Base
+{
+	public:
+	TerminalInit() noexcept = default;
+
+	TerminalInit(TerminalInit const&) noexcept = default;
+	TerminalInit& operator=(TerminalInit const&) noexcept = default;
+
+	virtual ~TerminalInit() = default;
+
+	char const* what() const noexcept override
+	{
+		return "nccpp::errors::TerminalInit : Can't create virtual terminal, pipe() failed";
+	}
+};
+
+/**
+ * \brief Thrown when an output sink can't be created.
+ */
+class OutputSinkInit : public Base
+{
+	public:
+	OutputSinkInit() noexcept = default;
+
+	OutputSinkInit(OutputSinkInit const&) noexcept = default;
+	OutputSinkInit& operator=(OutputSinkInit const&) noexcept = default;
+
+	virtual ~OutputSinkInit() = default;
+
+	char const* what() const noexcept override
+	{
+		return "nccpp::errors::OutputSinkInit : Can't create output sink, the output isn't a terminal or pipe() failed";
+	}
+};
+
+/**
+ * \brief Thrown when an event loop can't be created.
+ */
+class EventLoopInit : public Base
+{
+	public:
+	EventLoopInit() noexcept = default;
+
+	EventLoopInit(EventLoopInit const&) noexcept = default;
+	EventLoopInit& operator=(EventLoopInit const&) noexcept = default;
+
+	virtual ~EventLoopInit() = default;
+
+	char const* what() const noexcept override
+	{
+		return "nccpp::errors::EventLoopInit : Can't create event loop, pipe() failed";
+	}
+};
+
 /**
  * \brief Thrown when window creation fails.
  */
@@ -130,6 +206,25 @@ class ColorInit : public Base
 	}
 };
 
+/**
+ * \brief Thrown when a palette is registered after other colors.
+ */
+class PaletteInit : public Base
+{
+	public:
+	PaletteInit() noexcept = default;
+
+	PaletteInit(PaletteInit const&) noexcept = default;
+	PaletteInit& operator=(PaletteInit const&) noexcept = default;
+
+	virtual ~PaletteInit() = default;
+
+	char const* what() const noexcept override
+	{
+		return "nccpp::errors::PaletteInit : Can't register palette, colors are already registered";
+	}
+};
+
 /**
  * \brief Thrown when no more color pairs can be registered.
  */
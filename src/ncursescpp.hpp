@@ -47,8 +47,22 @@
  */
 
 #include "Window.hpp"
+#include "Screen.hpp"
+#include "ScreenPool.hpp"
 #include "Subwindow.hpp"
+#include "Layout.hpp"
+#include "Pad.hpp"
+#include "PagedPad.hpp"
 #include "Color.hpp"
+#include "Palette.hpp"
+#include "Style.hpp"
+#include "Canvas.hpp"
+#include "FrameScheduler.hpp"
+#include "TailView.hpp"
+#include "DrawQueue.hpp"
+#include "EventLoop.hpp"
+#include "OutputSink.hpp"
+#include "VirtualTerminal.hpp"
 #include "constants.hpp"
 #include "errors.hpp"
 